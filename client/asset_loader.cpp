@@ -0,0 +1,178 @@
+#include "asset_loader.h"
+#include "raylib_compat.h"
+
+AssetLoader::AssetLoader(const AssetPack& assetPack)
+: pack(assetPack), decodedCount(0), uploadIndex(0) {}
+
+AssetLoader::~AssetLoader() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+    for (int i = uploadIndex; i < static_cast<int>(jobs.size()); i++) {
+        if (jobs[i].ownsPixels) {
+            UnloadImage(jobs[i].image);
+        }
+    }
+}
+
+void AssetLoader::addTexture(const char* name, Texture2D* target) {
+    TextureJob job;
+    job.name = name;
+    job.target = target;
+    job.image = Image();
+    job.ownsPixels = false;
+    job.rowsUploaded = 0;
+    job.atlas = nullptr;
+    jobs.push_back(job);
+}
+
+void AssetLoader::addAtlas(const char* name, const std::vector<std::string>& sources, TextureAtlas* target) {
+    addTexture(name, &target->texture);
+    jobs.back().atlas = target;
+    jobs.back().sources = sources;
+}
+
+void AssetLoader::start() {
+    worker = std::thread(&AssetLoader::decode, this);
+}
+
+// Background thread: only touches CPU-side data, never the GL context
+void AssetLoader::decode() {
+    for (int i = 0; i < static_cast<int>(jobs.size()); i++) {
+        TextureJob& job = jobs[i];
+        const PackEntry* entry = pack.find(job.name.c_str(), PACK_TEXTURE);
+        const PackEntry* table = pack.find(job.name.c_str(), PACK_ATLAS);
+        if (job.atlas && table) {
+            ByteReader in(pack.data(*table), table->size);
+            if (!ReadAtlasRegions(in, job.regions)) {
+                entry = nullptr;
+            }
+        }
+        if (job.atlas && (!entry || !table)) {
+            decodeAtlas(job);
+        } else if (entry) {
+            job.image.data = const_cast<unsigned char*>(pack.data(*entry));
+            job.image.width = entry->params[0];
+            job.image.height = entry->params[1];
+            job.image.mipmaps = entry->params[2];
+            job.image.format = entry->params[3];
+            // Fault the pixels in here rather than in the middle of an upload
+            volatile unsigned char sink = 0;
+            const unsigned char* bytes = pack.data(*entry);
+            for (uint64_t offset = 0; offset < entry->size; offset += 4096) {
+                sink = sink + bytes[offset];
+            }
+        } else {
+            job.image = LoadImage(job.name.c_str());
+            if (job.image.data) {
+                ImageFormat(&job.image, PIXEL_FORMAT_RGBA8);
+                job.ownsPixels = true;
+            }
+        }
+        decodedCount.store(i + 1, std::memory_order_release);
+    }
+}
+
+// Builds an atlas the way the packer would, for running without an asset pack
+void AssetLoader::decodeAtlas(TextureJob& job) {
+    std::vector<Image> images;
+    std::vector<std::string> names;
+    for (const std::string& source : job.sources) {
+        Image image = LoadImage(source.c_str());
+        if (image.data) {
+            ImageFormat(&image, PIXEL_FORMAT_RGBA8);
+            images.push_back(image);
+            names.push_back(source);
+        }
+    }
+    job.image = BuildAtlasImage(images, names, job.regions);
+    job.ownsPixels = true;
+    for (Image& image : images) {
+        UnloadImage(image);
+    }
+}
+
+// Uploads rows of job within budget bytes. True when the texture is complete.
+bool AssetLoader::upload(TextureJob& job, int& budget) {
+    Image& image = job.image;
+    if (!image.data) {
+        *job.target = Texture2D();  // Failed to load; drawing it is a no-op
+        return true;
+    }
+    if (job.rowsUploaded == 0) {
+        // With no pixels this only allocates the texture, which the slices are then written into
+        Texture2D texture;
+        texture.id = rlLoadTexture(nullptr, image.width, image.height, image.format, 1);
+        texture.width = image.width;
+        texture.height = image.height;
+        texture.mipmaps = 1;
+        texture.format = image.format;
+        *job.target = texture;
+        if (job.atlas) {
+            job.atlas->regions = job.regions;
+        }
+    }
+
+    int rowBytes = GetPixelDataSize(image.width, 1, image.format);
+    int rows = budget / rowBytes;
+    if (rows < 1) {
+        rows = 1;
+    }
+    if (rows > image.height - job.rowsUploaded) {
+        rows = image.height - job.rowsUploaded;
+    }
+    Rectangle slice = {0.0f, static_cast<float>(job.rowsUploaded),
+                       static_cast<float>(image.width), static_cast<float>(rows)};
+    const unsigned char* pixels = static_cast<const unsigned char*>(image.data);
+    UpdateTextureRec(*job.target, slice, pixels + static_cast<size_t>(job.rowsUploaded) * rowBytes);
+    job.rowsUploaded += rows;
+    budget -= rows * rowBytes;
+
+    if (job.rowsUploaded < image.height) {
+        return false;
+    }
+    if (image.mipmaps > 1) {
+        GenTextureMipmaps(job.target);  // Only the base level is sliced; the GPU builds the rest
+    }
+    if (job.ownsPixels) {
+        UnloadImage(image);
+        job.ownsPixels = false;
+    }
+    image.data = nullptr;
+    return true;
+}
+
+bool AssetLoader::update() {
+    int budget = UPLOAD_BYTES_PER_FRAME;
+    int decoded = decodedCount.load(std::memory_order_acquire);
+    while (budget > 0 && uploadIndex < decoded) {
+        if (upload(jobs[uploadIndex], budget)) {
+            uploadIndex++;
+        }
+    }
+    return isDone();
+}
+
+void AssetLoader::finish() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+    while (uploadIndex < static_cast<int>(jobs.size())) {
+        int budget = 1 << 30;
+        if (upload(jobs[uploadIndex], budget)) {
+            uploadIndex++;
+        }
+    }
+}
+
+float AssetLoader::progress() const {
+    if (jobs.empty()) {
+        return 1.0f;
+    }
+    float done = static_cast<float>(uploadIndex);
+    // A job the worker has not finished is still being written, so leave it alone
+    if (uploadIndex < decodedCount.load(std::memory_order_acquire) && jobs[uploadIndex].image.height > 0) {
+        done += static_cast<float>(jobs[uploadIndex].rowsUploaded) / jobs[uploadIndex].image.height;
+    }
+    return done / jobs.size();
+}
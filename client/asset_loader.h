@@ -0,0 +1,54 @@
+#pragma once
+
+#include "raylib.h"
+#include "asset_pack.h"
+#include "atlas.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads textures while the instructions are on screen. A background thread does
+// the CPU side (decoding PNGs, or paging pack pixels in from disk) and the main
+// thread uploads to the GPU a few rows at a time, so no frame stalls on a big
+// decode or a full-screen glTexImage.
+class AssetLoader {
+public:
+    static const int UPLOAD_BYTES_PER_FRAME = 1 << 20;  // About 1/25 of the 3200x2000 RGBA background
+
+    explicit AssetLoader(const AssetPack& pack);
+    ~AssetLoader();
+
+    // Register everything before start(); target is filled in once its upload begins
+    void addTexture(const char* name, Texture2D* target);
+    // Taken from the pack when it has one called name, otherwise built from sources
+    void addAtlas(const char* name, const std::vector<std::string>& sources, TextureAtlas* target);
+    void start();
+
+    bool update();  // Main thread, once per frame. True once every texture is uploaded.
+    void finish();  // Uploads whatever is left in one go
+    bool isDone() const { return uploadIndex == static_cast<int>(jobs.size()); }
+    float progress() const;
+
+private:
+    struct TextureJob {
+        std::string name;
+        Texture2D* target;
+        Image image;         // RGBA pixels, either owned or pointing into the pack
+        bool ownsPixels;
+        int rowsUploaded;
+        TextureAtlas* atlas;               // Atlas jobs only
+        std::vector<std::string> sources;
+        std::vector<AtlasRegion> regions;
+    };
+
+    const AssetPack& pack;
+    std::vector<TextureJob> jobs;
+    std::thread worker;
+    std::atomic<int> decodedCount;  // Jobs [0, decodedCount) are ready to upload
+    int uploadIndex;
+
+    void decode();
+    void decodeAtlas(TextureJob& job);
+    bool upload(TextureJob& job, int& budget);
+};
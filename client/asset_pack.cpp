@@ -0,0 +1,52 @@
+#include "asset_pack.h"
+#include "../sim/byte_io.h"
+#include <cstring>
+
+bool AssetPack::open(const char* fileName) {
+    close();
+    if (!file.open(fileName)) {
+        return false;
+    }
+    ByteReader in(file.data(), file.size());
+    char magic[sizeof(PACK_MAGIC)];
+    if (!in.getBytes(magic, sizeof(magic)) || memcmp(magic, PACK_MAGIC, sizeof(magic)) != 0) {
+        close();
+        return false;
+    }
+    uint32_t count = in.get<uint32_t>();
+    for (uint32_t i = 0; i < count && in.ok(); i++) {
+        PackEntry entry;
+        entry.kind = static_cast<PackKind>(in.get<uint8_t>());
+        entry.name.resize(in.get<uint8_t>());
+        in.getBytes(&entry.name[0], entry.name.size());
+        entry.offset = in.get<uint64_t>();
+        entry.size = in.get<uint64_t>();
+        for (int32_t& param : entry.params) {
+            param = in.get<int32_t>();
+        }
+        if (entry.offset > file.size() || entry.size > file.size() - entry.offset) {
+            close();
+            return false;
+        }
+        entries.push_back(entry);
+    }
+    if (!in.ok()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    file.close();
+    entries.clear();
+}
+
+const PackEntry* AssetPack::find(const char* name, PackKind kind) const {
+    for (const PackEntry& entry : entries) {
+        if (entry.kind == kind && entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
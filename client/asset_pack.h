@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../sim/mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Asset archive written by tools/pack_assets (make pack). Textures are stored as
+// raw base-level pixels in their GPU format and audio as PCM, so loading is an
+// upload straight out of the memory map: no PNG inflate, no MP3 decode and no
+// decoded copy on the heap.
+//
+// Layout (little endian):
+//   "NTTDPAK1", u32 entry count
+//   per entry: u8 kind, u8 name length, name, u64 offset, u64 size, i32 a, b, c, d
+//     texture: width, height, mipmaps (1), PixelFormat
+//     sound:   sample count, sample rate, sample size, channels
+//     atlas:   unused; the blob is the region table of the texture with the same name
+//   blobs, each starting on a PACK_ALIGN boundary
+//
+// Entries are named by the source path they were packed from, so a lookup that
+// misses can load the original file instead.
+
+const char PACK_MAGIC[8] = {'N', 'T', 'T', 'D', 'P', 'A', 'K', '1'};
+const int PACK_ALIGN = 64;
+
+enum PackKind : uint8_t {
+    PACK_TEXTURE = 1,
+    PACK_SOUND = 2,
+    PACK_ATLAS = 3,
+};
+
+struct PackEntry {
+    PackKind kind;
+    std::string name;
+    uint64_t offset, size;
+    int32_t params[4];
+};
+
+class AssetPack {
+public:
+    bool open(const char* fileName);  // False when missing or unreadable; loads then fall back
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    const PackEntry* find(const char* name, PackKind kind) const;
+    const unsigned char* data(const PackEntry& entry) const { return file.data() + entry.offset; }
+
+private:
+    MappedFile file;
+    std::vector<PackEntry> entries;
+};
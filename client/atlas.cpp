@@ -0,0 +1,113 @@
+#include "atlas.h"
+#include "../sim/config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const int ATLAS_WIDTH = 2048;
+static const int ATLAS_PADDING = 2;  // Transparent gap so filtering never picks up a neighbour
+static const int WHITE_SIZE = 4;
+
+Rectangle TextureAtlas::region(const char* name) const {
+    for (const AtlasRegion& region : regions) {
+        if (region.name == name) {
+            return region.rect;
+        }
+    }
+    return Rectangle();
+}
+
+Rectangle TextureAtlas::whiteTexel() const {
+    Rectangle white = region(ATLAS_WHITE);
+    return {white.x + white.width / 2 - 0.5f, white.y + white.height / 2 - 0.5f, 1.0f, 1.0f};
+}
+
+// Anti-aliased white circle filling a size x size square
+static Image GenerateDisc(int size) {
+    Image disc = GenImageColor(size, size, BLANK);
+    Color* pixels = static_cast<Color*>(disc.data);
+    float radius = size / 2.0f;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float dx = x + 0.5f - radius;
+            float dy = y + 0.5f - radius;
+            float coverage = std::min(std::max(radius - sqrtf(dx * dx + dy * dy) + 0.5f, 0.0f), 1.0f);
+            pixels[y * size + x] = {255, 255, 255, static_cast<unsigned char>(coverage * 255)};
+        }
+    }
+    return disc;
+}
+
+Image BuildAtlasImage(const std::vector<Image>& sources, const std::vector<std::string>& sourceNames,
+                      std::vector<AtlasRegion>& regions) {
+    std::vector<Image> images = sources;
+    std::vector<std::string> names = sourceNames;
+    Image white = GenImageColor(WHITE_SIZE, WHITE_SIZE, WHITE);
+    Image disc = GenerateDisc(2 * BALL_RADIUS);
+    images.push_back(white);
+    names.push_back(ATLAS_WHITE);
+    images.push_back(disc);
+    names.push_back(ATLAS_DISC);
+
+    int width = ATLAS_WIDTH;
+    for (const Image& image : images) {
+        width = std::max(width, image.width + ATLAS_PADDING);
+    }
+
+    // Left to right in rows; a row is as tall as its tallest image
+    regions.clear();
+    int x = 0, y = 0, rowHeight = 0;
+    for (size_t i = 0; i < images.size(); i++) {
+        if (x + images[i].width > width) {
+            x = 0;
+            y += rowHeight + ATLAS_PADDING;
+            rowHeight = 0;
+        }
+        regions.push_back({names[i], {static_cast<float>(x), static_cast<float>(y),
+                                      static_cast<float>(images[i].width), static_cast<float>(images[i].height)}});
+        x += images[i].width + ATLAS_PADDING;
+        rowHeight = std::max(rowHeight, images[i].height);
+    }
+
+    Image atlas = GenImageColor(width, y + rowHeight, BLANK);
+    Color* dst = static_cast<Color*>(atlas.data);
+    for (size_t i = 0; i < images.size(); i++) {
+        const Color* src = static_cast<const Color*>(images[i].data);
+        int left = static_cast<int>(regions[i].rect.x);
+        int top = static_cast<int>(regions[i].rect.y);
+        for (int row = 0; row < images[i].height; row++) {
+            memcpy(dst + (top + row) * width + left, src + row * images[i].width, images[i].width * sizeof(Color));
+        }
+    }
+    UnloadImage(white);
+    UnloadImage(disc);
+    return atlas;
+}
+
+void WriteAtlasRegions(ByteWriter& out, const std::vector<AtlasRegion>& regions) {
+    out.put(static_cast<uint32_t>(regions.size()));
+    for (const AtlasRegion& region : regions) {
+        out.put(static_cast<uint8_t>(region.name.size()));
+        out.putBytes(region.name.data(), region.name.size());
+        out.put(region.rect.x);
+        out.put(region.rect.y);
+        out.put(region.rect.width);
+        out.put(region.rect.height);
+    }
+}
+
+bool ReadAtlasRegions(ByteReader& in, std::vector<AtlasRegion>& regions) {
+    uint32_t count = in.get<uint32_t>();
+    regions.clear();
+    for (uint32_t i = 0; i < count && in.ok(); i++) {
+        AtlasRegion region;
+        region.name.resize(in.get<uint8_t>());
+        in.getBytes(&region.name[0], region.name.size());
+        region.rect.x = in.get<float>();
+        region.rect.y = in.get<float>();
+        region.rect.width = in.get<float>();
+        region.rect.height = in.get<float>();
+        regions.push_back(region);
+    }
+    return in.ok();
+}
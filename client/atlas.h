@@ -0,0 +1,33 @@
+#pragma once
+
+#include "raylib.h"
+#include "../sim/byte_io.h"
+#include <string>
+#include <vector>
+
+// Sprites packed into one texture so the background, hero, balls (without the
+// circle shader) and UI shapes all draw from the same texture and batch together.
+// Regions are named by the file they came from; two generated ones are added:
+const char* const ATLAS_WHITE = "white";  // Solid block, tinted for plain rectangles
+const char* const ATLAS_DISC = "disc";    // Ball-sized circle, when the circle shader is unavailable
+
+struct AtlasRegion {
+    std::string name;
+    Rectangle rect;
+};
+
+struct TextureAtlas {
+    Texture2D texture;
+    std::vector<AtlasRegion> regions;
+
+    Rectangle region(const char* name) const;  // Empty when missing
+    Rectangle whiteTexel() const;              // Centre of the white block, clear of any bleed
+};
+
+// Shelf-packs RGBA8 images in the given order, then the generated regions. Used by
+// the offline packer and, without an asset pack, by the loader at startup.
+Image BuildAtlasImage(const std::vector<Image>& images, const std::vector<std::string>& names,
+                      std::vector<AtlasRegion>& regions);
+
+void WriteAtlasRegions(ByteWriter& out, const std::vector<AtlasRegion>& regions);
+bool ReadAtlasRegions(ByteReader& in, std::vector<AtlasRegion>& regions);
@@ -0,0 +1,46 @@
+#include "ball_renderer.h"
+#include "raylib_compat.h"
+
+// Quad texcoords run 0..1; distance from the center in radii gives the circle,
+// and fwidth keeps the anti-aliased edge one pixel wide at any radius.
+static const char* CIRCLE_FS =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    float d = length(fragTexCoord * 2.0 - 1.0) - 1.0;\n"
+    "    float aa = fwidth(d);\n"
+    "    finalColor = vec4(fragColor.rgb, fragColor.a * (1.0 - smoothstep(-aa, aa, d)));\n"
+    "}\n";
+
+BallRenderer::BallRenderer()
+: circleShader(), hasShader(false) {}
+
+void BallRenderer::load() {
+    circleShader = LoadShaderFragment(CIRCLE_FS);
+    hasShader = !IsDefaultShader(circleShader);
+}
+
+void BallRenderer::unload() {
+    if (hasShader) {
+        UnloadShader(circleShader);
+        hasShader = false;
+    }
+}
+
+void BallRenderer::draw(DrawList& list, const TextureAtlas& atlas, const BallSystem& balls, float alpha, bool yellow) {
+    Color color = yellow ? YELLOW : WHITE;
+
+    // The shader draws the circle across 0..1 texcoords of the 1x1 default texture
+    Texture2D texture = hasShader ? DefaultTexture() : atlas.texture;
+    Rectangle source = hasShader ? Rectangle{0.0f, 0.0f, 1.0f, 1.0f} : atlas.region(ATLAS_DISC);
+    const Shader* shader = hasShader ? &circleShader : nullptr;
+    int count = balls.size();
+    for (int i = 0; i < count; i++) {
+        float x = lerp(balls.prevPosX(i), balls.posX(i), alpha);
+        float y = lerp(balls.prevPosY(i), balls.posY(i), alpha);
+        float r = balls.radius[i];
+        list.add(LAYER_BALLS, texture, source, {x - r, y - r, 2 * r, 2 * r}, color, shader);
+    }
+}
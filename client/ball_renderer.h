@@ -0,0 +1,25 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include "draw_list.h"
+#include "../sim/ball_system.h"
+
+// Draws every ball as a quad shaded with a signed-distance circle, instead of a
+// tessellated DrawCircle fan per ball. Each ball's interpolated position is read
+// straight from the BallSystem columns and submitted as a 4-vertex quad; the quads
+// share a texture and shader, so rlgl sends them in a single batch. Without the
+// shader the quads sample the atlas's prebaked disc and batch with the sprites.
+class BallRenderer {
+public:
+    BallRenderer();
+
+    void load();
+    void unload();
+    // Balls carry no colour; the world phase picks one for all of them
+    void draw(DrawList& list, const TextureAtlas& atlas, const BallSystem& balls, float alpha, bool yellow);
+
+private:
+    Shader circleShader;
+    bool hasShader;
+};
@@ -0,0 +1,61 @@
+#include "draw_list.h"
+#include <algorithm>
+
+DrawList::DrawList()
+: batches(0) {}
+
+void DrawList::clear() {
+    quads.clear();
+    runs.clear();
+}
+
+void DrawList::add(DrawLayer layer, Texture2D texture, Rectangle source, Rectangle dest, Color tint,
+                   const Shader* shader) {
+    unsigned long long shaderId = shader ? shader->id : 0;
+    unsigned long long key = (static_cast<unsigned long long>(layer) << 48) | (shaderId << 32) | texture.id;
+    if (runs.empty() || runs.back().key != key) {
+        Run run;
+        run.key = key;
+        run.shader = shader;
+        run.texture = texture;
+        run.first = static_cast<int>(quads.size());
+        run.count = 0;
+        runs.push_back(run);
+    }
+    runs.back().count++;
+    quads.push_back({source, dest, tint});
+}
+
+void DrawList::flush() {
+    // Stable, so equal keys keep submission order: glyphs stay in text order. Runs
+    // are few, so this is cheap however many quads they hold.
+    std::stable_sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.key < b.key; });
+
+    batches = 0;
+    const Shader* shader = nullptr;
+    unsigned long long runKey = ~0ULL;
+    for (const Run& run : runs) {
+        unsigned long long key = run.key & 0xFFFFFFFFFFFFULL;  // A new layer alone does not break a batch
+        if (key != runKey) {
+            if (run.shader != shader) {
+                if (shader) {
+                    EndShaderMode();
+                }
+                if (run.shader) {
+                    BeginShaderMode(*run.shader);
+                }
+                shader = run.shader;
+            }
+            runKey = key;
+            batches++;
+        }
+        for (int i = run.first; i < run.first + run.count; i++) {
+            const Quad& quad = quads[i];
+            DrawTexturePro(run.texture, quad.source, quad.dest, {0.0f, 0.0f}, 0.0f, quad.tint);
+        }
+    }
+    if (shader) {
+        EndShaderMode();
+    }
+    clear();
+}
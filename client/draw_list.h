@@ -0,0 +1,52 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// Back to front. Anything in a higher layer covers anything in a lower one; inside
+// a layer items are grouped by shader and texture, so only order between items
+// sharing both is kept.
+enum DrawLayer {
+    LAYER_BACKGROUND,
+    LAYER_BALLS,
+    LAYER_SPRITES,
+    LAYER_HUD_SHAPES,
+    LAYER_HUD_TEXT,
+};
+
+// Textured quads collected over a frame and submitted sorted by layer, shader and
+// texture, so every run that shares a shader and texture reaches rlgl as one draw.
+// A shader change flushes rlgl's whole batch and a texture change starts a new
+// draw call, so the frame costs one batch per run; lastBatches() reports how many.
+// Quads added back to back with the same layer, shader and texture are queued as
+// one run, and only runs are sorted, so a thousand balls cost one sort entry.
+class DrawList {
+public:
+    DrawList();
+
+    void clear();
+    void add(DrawLayer layer, Texture2D texture, Rectangle source, Rectangle dest, Color tint,
+             const Shader* shader = nullptr);
+    void flush();  // Draws everything and clears the list
+
+    int size() const { return static_cast<int>(quads.size()); }
+    int lastBatches() const { return batches; }
+
+private:
+    struct Quad {
+        Rectangle source, dest;
+        Color tint;
+    };
+
+    // Consecutive quads in the quads array sharing a key
+    struct Run {
+        unsigned long long key;  // Layer, shader id, texture id
+        const Shader* shader;
+        Texture2D texture;
+        int first, count;
+    };
+
+    std::vector<Quad> quads;
+    std::vector<Run> runs;
+    int batches;
+};
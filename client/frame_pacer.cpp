@@ -0,0 +1,168 @@
+#include "frame_pacer.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#if defined(RAYLIB_VERSION) && !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+// raylib polls input only inside EndDrawing, ahead of the pacer's sleep. Polling
+// GLFW again after that sleep updates the key and mouse state raylib reads; the
+// previous-frame state it compares against for presses is still rolled over in
+// EndDrawing. raylib's own PollInputEvents would roll it over a second time and
+// lose the presses seen in EndDrawing, so GLFW is called directly.
+#ifndef RAYLIB_VERSION
+// raylib 3.0 links its bundled GLFW in and exports it
+extern "C" void glfwPollEvents(void);
+
+static bool CanRepollEvents() {
+    return true;
+}
+
+static bool RepollEvents() {
+    glfwPollEvents();
+    return true;
+}
+#else
+// Newer raylib may link GLFW in or use the system's, so it is found at run time.
+// A static libraylib.a linked without -rdynamic exports nothing to find.
+typedef void (*PollFn)(void);
+
+static PollFn FindGlfwPoll() {
+#ifndef _WIN32
+    static PollFn poll = reinterpret_cast<PollFn>(dlsym(RTLD_DEFAULT, "glfwPollEvents"));
+    return poll;
+#else
+    return nullptr;
+#endif
+}
+
+static bool CanRepollEvents() {
+    return FindGlfwPoll() != nullptr;
+}
+
+static bool RepollEvents() {
+    PollFn poll = FindGlfwPoll();
+    if (!poll) {
+        return false;
+    }
+    poll();
+    return true;
+}
+#endif
+
+// Sleeps are only trusted to within this; the rest is spun
+const std::chrono::microseconds SPIN_TIME(1000);
+
+LatencyHistogram::LatencyHistogram()
+: buckets(BUCKETS, 0), total(0), sum(0.0), minSeen(0.0), maxSeen(0.0) {}
+
+void LatencyHistogram::clear() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    total = 0;
+    sum = 0.0;
+    minSeen = 0.0;
+    maxSeen = 0.0;
+}
+
+void LatencyHistogram::add(double ms) {
+    int bucket = static_cast<int>(ms / BUCKET_MS);
+    buckets[std::min(std::max(bucket, 0), BUCKETS - 1)]++;
+    minSeen = total ? std::min(minSeen, ms) : ms;
+    maxSeen = std::max(maxSeen, ms);
+    sum += ms;
+    total++;
+}
+
+double LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    long long rank = static_cast<long long>(p / 100.0 * (total - 1));
+    long long seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen > rank) {
+            return std::min((b + 1) * BUCKET_MS, maxSeen);
+        }
+    }
+    return maxSeen;
+}
+
+bool LatencyHistogram::writeCsv(const char* fileName) const {
+    FILE* file = fopen(fileName, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "from_ms,to_ms,frames\n");
+    for (int b = 0; b < BUCKETS; b++) {
+        if (buckets[b] == 0) {
+            continue;
+        }
+        if (b == BUCKETS - 1) {
+            fprintf(file, "%.2f,,%lld\n", b * BUCKET_MS, buckets[b]);
+        } else {
+            fprintf(file, "%.2f,%.2f,%lld\n", b * BUCKET_MS, (b + 1) * BUCKET_MS, buckets[b]);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+FramePacer::FramePacer(FramePacing pacing, int hz)
+: mode(pacing), refreshHz(hz > 0 ? hz : 60), hasPresented(false), workMs(BUDGET_FRAMES, 0.0), workIndex(0) {
+    // Sleeping before input only helps if input can be polled again after the sleep
+    if (mode == PACING_LOW_LATENCY && !CanRepollEvents()) {
+        mode = PACING_DEFAULT;
+    }
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / refreshHz));
+}
+
+int FramePacer::targetFps() const {
+    return mode == PACING_LOW_LATENCY ? 0 : refreshHz;
+}
+
+double FramePacer::budgetMs() const {
+    double periodMs = std::chrono::duration<double, std::milli>(period).count();
+    double worst = *std::max_element(workMs.begin(), workMs.end());
+    return std::min(worst + PRESENT_MARGIN_MS, periodMs);
+}
+
+void FramePacer::begin() {
+    if (mode == PACING_LOW_LATENCY) {
+        if (hasPresented) {
+            std::chrono::duration<double, std::milli> budget(budgetMs());
+            waitUntil(nextPresent - std::chrono::duration_cast<Clock::duration>(budget));
+        }
+        // Without a fresh poll the input is from the last EndDrawing, as in the default mode
+        inputTime = (RepollEvents() || !hasPresented) ? Clock::now() : lastPresent;
+    } else {
+        // Input was polled inside the last EndDrawing, before raylib's sleep, so this
+        // understates the default mode's latency by that sleep
+        inputTime = hasPresented ? lastPresent : Clock::now();
+    }
+}
+
+void FramePacer::beforePresent() {
+    std::chrono::duration<double, std::milli> work = Clock::now() - inputTime;
+    workMs[workIndex] = work.count();
+    workIndex = (workIndex + 1) % BUDGET_FRAMES;
+}
+
+void FramePacer::presented() {
+    lastPresent = Clock::now();
+    // With vsync the present returned at a refresh and the next one is a period on.
+    // Without it, keep to the schedule instead of drifting early by the margin.
+    nextPresent = (hasPresented ? std::max(nextPresent, lastPresent) : lastPresent) + period;
+    hasPresented = true;
+    std::chrono::duration<double, std::milli> latency = lastPresent - inputTime;
+    histogram.add(latency.count());
+}
+
+void FramePacer::waitUntil(Clock::time_point wake) const {
+    if (wake - Clock::now() > SPIN_TIME) {
+        std::this_thread::sleep_until(wake - SPIN_TIME);
+    }
+    while (Clock::now() < wake) {
+    }
+}
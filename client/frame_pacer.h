@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+enum FramePacing {
+    PACING_DEFAULT,      // raylib's SetTargetFPS: present, poll input, then sleep out the frame
+    PACING_LOW_LATENCY,  // Sleep first, then poll input, simulate and present just in time
+};
+
+// Input-to-present times over a run, in fixed 0.25 ms buckets up to 50 ms; the
+// last bucket also takes everything slower
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 200;
+    static constexpr double BUCKET_MS = 0.25;
+
+    LatencyHistogram();
+
+    void clear();
+    void add(double ms);
+
+    long long count() const { return total; }
+    double minMs() const { return total ? minSeen : 0.0; }
+    double avgMs() const { return total ? sum / total : 0.0; }
+    double maxMs() const { return maxSeen; }
+    double percentile(double p) const;  // Upper edge of the bucket holding it
+    bool writeCsv(const char* fileName) const;
+
+private:
+    std::vector<long long> buckets;
+    long long total;
+    double sum, minSeen, maxSeen;
+};
+
+// Paces frames to the display and timestamps each one from input sampling to
+// the return of EndDrawing. In low-latency mode raylib's own frame limiter is
+// off; the pacer instead sleeps at the start of the frame until just enough time
+// is left before the next present for the recent worst frame, then polls input.
+// Input is a fraction of a frame old when it is shown instead of nearly a whole one.
+class FramePacer {
+public:
+    static const int BUDGET_FRAMES = 120;            // Frames whose work times set the budget
+    static constexpr double PRESENT_MARGIN_MS = 2.0;  // Slack for the swap and the driver
+
+    // Falls back to PACING_DEFAULT when input cannot be re-polled after the sleep
+    FramePacer(FramePacing mode, int refreshHz);
+
+    FramePacing getMode() const { return mode; }
+    int targetFps() const;  // What to hand SetTargetFPS
+
+    void begin();          // Start of frame, before input is read
+    void beforePresent();  // Right before EndDrawing
+    void presented();      // Right after EndDrawing
+
+    const LatencyHistogram& latency() const { return histogram; }
+    void resetLatency() { histogram.clear(); }
+    double budgetMs() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    FramePacing mode;
+    int refreshHz;
+    Clock::duration period;
+    bool hasPresented;
+    Clock::time_point lastPresent;
+    Clock::time_point nextPresent;  // When the frame being built should be shown
+    Clock::time_point inputTime;
+    std::vector<double> workMs;  // Input to EndDrawing, ring of BUDGET_FRAMES
+    int workIndex;
+    LatencyHistogram histogram;
+
+    void waitUntil(Clock::time_point wake) const;
+};
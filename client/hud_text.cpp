@@ -0,0 +1,100 @@
+#include "hud_text.h"
+#include "raylib_compat.h"
+#include <cstdio>
+
+static const int DEFAULT_FONT_SIZE = 10;  // raylib's default font is baked at 10 px
+
+HudText::HudText(int size)
+: fontSize(size < DEFAULT_FONT_SIZE ? DEFAULT_FONT_SIZE : size),
+  hasValue(false), lastValue(0.0), dirty(true), textWidth(0.0f) {}
+
+HudText::HudText(const char* initial, int size)
+: HudText(size) {
+    text = initial;
+}
+
+void HudText::set(const char* newText) {
+    hasValue = false;
+    if (text != newText) {
+        text = newText;
+        dirty = true;
+    }
+}
+
+bool HudText::sameValue(double value) {
+    if (hasValue && value == lastValue) {
+        return true;
+    }
+    hasValue = true;
+    lastValue = value;
+    return false;
+}
+
+void HudText::set(const char* format, int value) {
+    if (sameValue(value)) {
+        return;
+    }
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), format, value);
+    text = buffer;
+    dirty = true;
+}
+
+void HudText::set(const char* format, double value) {
+    if (sameValue(value)) {
+        return;
+    }
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), format, value);
+    text = buffer;
+    dirty = true;
+}
+
+// Same placement DrawText/DrawTextEx would compute, done once per change
+void HudText::layout() const {
+    Font font = GetFontDefault();
+    float scale = static_cast<float>(fontSize) / font.baseSize;
+    int spacing = fontSize / DEFAULT_FONT_SIZE;
+    glyphs.clear();
+    float offsetX = 0.0f;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        int index = GetGlyphIndex(font, c);
+        const Rectangle& rec = font.recs[index];
+        const FontGlyph& info = GetFontGlyph(font, index);
+        if (c != ' ' && c != '\t') {
+            Glyph glyph;
+            glyph.source = rec;
+            glyph.dest = {offsetX + info.offsetX * scale, info.offsetY * scale, rec.width * scale, rec.height * scale};
+            glyphs.push_back(glyph);
+        }
+        offsetX += (info.advanceX == 0 ? rec.width : info.advanceX) * scale;
+        if (i + 1 < text.size()) {
+            offsetX += spacing;
+        }
+    }
+    textWidth = offsetX;
+    dirty = false;
+}
+
+int HudText::width() const {
+    if (dirty) {
+        layout();
+    }
+    return static_cast<int>(textWidth);
+}
+
+void HudText::draw(DrawList& list, float x, float y, Color color) const {
+    if (dirty) {
+        layout();
+    }
+    Texture2D atlas = GetFontDefault().texture;
+    for (const Glyph& glyph : glyphs) {
+        Rectangle dest = {x + glyph.dest.x, y + glyph.dest.y, glyph.dest.width, glyph.dest.height};
+        list.add(LAYER_HUD_TEXT, atlas, glyph.source, dest, color);
+    }
+}
+
+void HudText::drawCentered(DrawList& list, float centerX, float y, Color color) const {
+    draw(list, centerX - width() / 2, y, color);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "raylib.h"
+#include "draw_list.h"
+#include <string>
+#include <vector>
+
+// One line of HUD text in raylib's default font, laid out once into glyph quads
+// against the font's prebaked atlas. Drawing replays the quads; formatting,
+// measuring and glyph lookup only happen again when the text changes.
+class HudText {
+public:
+    explicit HudText(int fontSize);
+    HudText(const char* text, int fontSize);  // Static text, laid out on first use
+
+    void set(const char* text);
+    // Format only when the value differs from the last one shown
+    void set(const char* format, int value);
+    void set(const char* format, double value);
+
+    int width() const;  // Same as MeasureText
+    void draw(DrawList& list, float x, float y, Color color) const;
+    void drawCentered(DrawList& list, float centerX, float y, Color color) const;
+
+private:
+    struct Glyph {
+        Rectangle source;  // In the font atlas
+        Rectangle dest;    // Relative to the text origin
+    };
+
+    int fontSize;
+    std::string text;
+    bool hasValue;
+    double lastValue;
+    mutable bool dirty;
+    mutable float textWidth;
+    mutable std::vector<Glyph> glyphs;
+
+    bool sameValue(double value);
+    void layout() const;
+};
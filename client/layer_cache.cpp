@@ -0,0 +1,40 @@
+#include "layer_cache.h"
+
+LayerCache::LayerCache()
+: target({}), valid(false), key(0), composes(0) {}
+
+void LayerCache::load(int width, int height) {
+    target = LoadRenderTexture(width, height);
+    valid = false;
+}
+
+void LayerCache::unload() {
+    if (target.id != 0) {
+        UnloadRenderTexture(target);
+    }
+    target = {};
+    valid = false;
+}
+
+void LayerCache::invalidateUnless(unsigned long long newKey) {
+    if (newKey != key) {
+        key = newKey;
+        valid = false;
+    }
+}
+
+void LayerCache::compose(DrawList& list, Color clear) {
+    BeginTextureMode(target);
+    ClearBackground(clear);
+    list.flush();
+    EndTextureMode();
+    valid = true;
+    composes++;
+}
+
+void LayerCache::draw(DrawList& list, DrawLayer layer) const {
+    float width = static_cast<float>(target.texture.width);
+    float height = static_cast<float>(target.texture.height);
+    // Render textures are stored bottom-up
+    list.add(layer, target.texture, {0.0f, 0.0f, width, -height}, {0.0f, 0.0f, width, height}, WHITE);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "raylib.h"
+#include "draw_list.h"
+
+// A static layer composed once into a screen-sized render texture and then drawn
+// as a single opaque quad, instead of resubmitting and refilling everything in it
+// every frame. The owner calls invalidate() when what the layer shows changes;
+// only then is it composed again.
+class LayerCache {
+public:
+    LayerCache();
+
+    void load(int width, int height);
+    void unload();
+
+    void invalidate() { valid = false; }
+    // Invalidates when the key differs from the one the layer was composed with,
+    // so callers can hand in whatever the layer's content depends on
+    void invalidateUnless(unsigned long long key);
+    bool isValid() const { return valid; }
+
+    // Flushes the list into the texture over an opaque clear colour and marks the
+    // layer valid. Call outside BeginDrawing/EndDrawing.
+    void compose(DrawList& list, Color clear);
+    void draw(DrawList& list, DrawLayer layer) const;
+
+    int composeCount() const { return composes; }
+
+private:
+    RenderTexture2D target;
+    bool valid;
+    unsigned long long key;
+    int composes;
+};
@@ -0,0 +1,96 @@
+#include "music_player.h"
+#include "raylib_compat.h"
+#include <vector>
+
+MusicPlayer::MusicPlayer()
+: loaded(false), fromPack(false), music(), stream(), pcm(nullptr), frames(0), cursor(0), frameBytes(0), silentBuffers(0) {}
+
+bool MusicPlayer::load(const AssetPack& pack, const char* name) {
+    unload();
+    const PackEntry* entry = pack.find(name, PACK_SOUND);
+    if (entry && entry->params[2] == 16 && entry->params[3] > 0) {
+        unsigned int channels = static_cast<unsigned int>(entry->params[3]);
+        pcm = pack.data(*entry);
+        frames = static_cast<unsigned int>(entry->params[0]) / channels;
+        frameBytes = channels * 2;
+        cursor = 0;
+        silentBuffers = 0;
+        SetAudioStreamBufferSizeDefault(STREAM_FRAMES);
+        stream = OpenAudioStream(static_cast<unsigned int>(entry->params[1]), 16, channels);
+        fromPack = true;
+        loaded = stream.buffer != nullptr;
+        return loaded;
+    }
+
+    music = LoadMusicStream(name);
+    music.looping = false;  // Plays once, as the soundtrack always has
+    fromPack = false;
+    loaded = music.ctxData != nullptr;
+    return loaded;
+}
+
+void MusicPlayer::unload() {
+    if (!loaded) {
+        return;
+    }
+    if (fromPack) {
+        ReleaseAudioStream(stream);
+    } else {
+        UnloadMusicStream(music);
+    }
+    loaded = false;
+    pcm = nullptr;
+}
+
+void MusicPlayer::play() {
+    if (!loaded) {
+        return;
+    }
+    if (fromPack) {
+        update();  // Prime the ring so playback starts with real samples
+        PlayAudioStream(stream);
+    } else {
+        PlayMusicStream(music);
+    }
+}
+
+void MusicPlayer::update() {
+    if (!loaded) {
+        return;
+    }
+    if (!fromPack) {
+        UpdateMusicStream(music);
+        return;
+    }
+    while (IsAudioStreamProcessed(stream)) {
+        if (cursor >= frames) {
+            // The stream alternates between two buffers, so the next one to free up
+            // may be the other buffer, with the last chunk only just started. Two
+            // buffers of silence go in behind it; by the time a buffer frees up after
+            // both, the last chunk has played in full whichever buffer it was in.
+            if (silentBuffers == 2) {
+                StopAudioStream(stream);
+                return;
+            }
+            std::vector<unsigned char> silence(frameBytes, 0);
+            QueueAudioFrames(stream, silence.data(), 1);  // Padded with silence to a full buffer
+            silentBuffers++;
+            continue;
+        }
+        unsigned int chunk = frames - cursor < STREAM_FRAMES ? frames - cursor : STREAM_FRAMES;
+        // raylib pads a short final chunk with silence
+        QueueAudioFrames(stream, pcm + static_cast<size_t>(cursor) * frameBytes, chunk);
+        cursor += chunk;
+    }
+}
+
+void MusicPlayer::setPitch(float pitch) {
+    if (!loaded) {
+        return;
+    }
+    if (fromPack) {
+        SetAudioStreamPitch(stream, pitch);
+    } else {
+        SetMusicPitch(music, pitch);
+    }
+}
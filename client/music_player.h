@@ -0,0 +1,33 @@
+#pragma once
+
+#include "raylib.h"
+#include "asset_pack.h"
+
+// Background track played through a small ring buffer instead of a fully decoded
+// Sound. With the track in the asset pack, refills copy 16-bit PCM straight out of
+// the memory map; otherwise raylib's music stream decodes the file a chunk at a
+// time. Either way nothing is decoded up front and only a few KB stay resident.
+class MusicPlayer {
+public:
+    static const int STREAM_FRAMES = 4096;  // Frames per refill, about 90 ms at 44.1 kHz
+
+    MusicPlayer();
+
+    // The pack has to stay open while the track plays from it
+    bool load(const AssetPack& pack, const char* name);
+    void unload();
+    void play();
+    void update();  // Once per frame: refills whichever part of the ring has played
+    void setPitch(float pitch);
+
+private:
+    bool loaded;
+    bool fromPack;
+    Music music;
+    AudioStream stream;
+    const unsigned char* pcm;  // Pack blob, interleaved 16-bit frames
+    unsigned int frames;
+    unsigned int cursor;       // Next frame to queue
+    unsigned int frameBytes;
+    int silentBuffers;         // Queued behind the last chunk, so its end can be seen
+};
@@ -0,0 +1,35 @@
+#include "profiler_overlay.h"
+#include "raylib.h"
+
+void DrawProfilerOverlay(const FrameProfiler& profiler, const FramePacer& pacer, int batches, int x, int y) {
+    const int fontSize = 20;
+    const int rowHeight = 24;
+    const int columns[] = {0, 130, 220, 310};
+
+    DrawRectangle(x - 10, y - 10, 420, rowHeight * (PROFILE_PHASE_COUNT + 3) + 20, Fade(BLACK, 0.7f));
+    DrawText("phase", x + columns[0], y, fontSize, LIGHTGRAY);
+    DrawText("min ms", x + columns[1], y, fontSize, LIGHTGRAY);
+    DrawText("avg ms", x + columns[2], y, fontSize, LIGHTGRAY);
+    DrawText("p99 ms", x + columns[3], y, fontSize, LIGHTGRAY);
+
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        ProfilePhase phase = static_cast<ProfilePhase>(p);
+        ProfileStats stats = profiler.stats(phase);
+        int rowY = y + rowHeight * (p + 1);
+        Color color = phase == PROFILE_FRAME ? YELLOW : WHITE;
+        DrawText(FrameProfiler::phaseName(phase), x + columns[0], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", stats.minMs), x + columns[1], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", stats.avgMs), x + columns[2], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", stats.p99Ms), x + columns[3], rowY, fontSize, color);
+    }
+
+    const LatencyHistogram& latency = pacer.latency();
+    int latencyY = y + rowHeight * (PROFILE_PHASE_COUNT + 1);
+    DrawText("latency", x + columns[0], latencyY, fontSize, SKYBLUE);
+    DrawText(TextFormat("%.3f", latency.minMs()), x + columns[1], latencyY, fontSize, SKYBLUE);
+    DrawText(TextFormat("%.3f", latency.avgMs()), x + columns[2], latencyY, fontSize, SKYBLUE);
+    DrawText(TextFormat("%.3f", latency.percentile(99.0)), x + columns[3], latencyY, fontSize, SKYBLUE);
+
+    const char* pacing = pacer.getMode() == PACING_LOW_LATENCY ? "low latency" : "default";
+    DrawText(TextFormat("batches %i   pacing %s", batches, pacing), x + columns[0], y + rowHeight * (PROFILE_PHASE_COUNT + 2), fontSize, LIGHTGRAY);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "frame_pacer.h"
+#include "../sim/profiler.h"
+
+// Table of rolling min/avg/p99 per frame phase, drawn over the game (F3), with the
+// input-to-present latency since the game started and the number of draw batches
+// the last frame was submitted in
+void DrawProfilerOverlay(const FrameProfiler& profiler, const FramePacer& pacer, int batches, int x, int y);
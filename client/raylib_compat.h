@@ -0,0 +1,95 @@
+#pragma once
+
+#include "raylib.h"
+
+// Windows builds against the raylib 3.0 header and library bundled in include/
+// and lib/; Linux and macOS build against the system raylib, which is 4.0 or
+// newer. 3.0's header defines no RAYLIB_VERSION, so that tells them apart. Calls
+// whose names or arguments changed between the two go through here.
+#ifdef RAYLIB_VERSION
+#include "rlgl.h"
+#endif
+
+// 32-bit RGBA, the format every texture is stored and uploaded in
+#ifdef RAYLIB_VERSION
+const int PIXEL_FORMAT_RGBA8 = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+#else
+const int PIXEL_FORMAT_RGBA8 = UNCOMPRESSED_R8G8B8A8;
+#endif
+
+// Allocates a texture, uploading pixels when given. 3.0 exports rlgl's loader but
+// its bundled header leaves it out; 4.0 declares it in rlgl.h.
+#ifndef RAYLIB_VERSION
+extern "C" unsigned int rlLoadTexture(void* data, int width, int height, int format, int mipmapCount);
+#endif
+
+// Fragment-only shader over raylib's default vertex shader
+inline Shader LoadShaderFragment(const char* fragmentCode) {
+#ifdef RAYLIB_VERSION
+    return LoadShaderFromMemory(nullptr, fragmentCode);
+#else
+    return LoadShaderCode(nullptr, fragmentCode);
+#endif
+}
+
+// Both versions hand back the default shader when compilation fails
+inline bool IsDefaultShader(Shader shader) {
+#ifdef RAYLIB_VERSION
+    return shader.id == 0 || shader.id == rlGetShaderIdDefault();
+#else
+    return shader.id == GetShaderDefault().id;
+#endif
+}
+
+// rlgl's 1x1 white texture
+inline Texture2D DefaultTexture() {
+#ifdef RAYLIB_VERSION
+    return {rlGetTextureIdDefault(), 1, 1, 1, PIXEL_FORMAT_RGBA8};
+#else
+    return GetTextureDefault();
+#endif
+}
+
+// Samples over all channels; 3.0 stores this, 4.0 stores frames
+inline unsigned int WaveSampleTotal(const Wave& wave) {
+#ifdef RAYLIB_VERSION
+    return wave.frameCount * wave.channels;
+#else
+    return wave.sampleCount;
+#endif
+}
+
+// Raw PCM stream; 4.0 renamed the pair
+inline AudioStream OpenAudioStream(unsigned int sampleRate, unsigned int sampleSize, unsigned int channels) {
+#ifdef RAYLIB_VERSION
+    return LoadAudioStream(sampleRate, sampleSize, channels);
+#else
+    return InitAudioStream(sampleRate, sampleSize, channels);
+#endif
+}
+
+inline void ReleaseAudioStream(AudioStream stream) {
+#ifdef RAYLIB_VERSION
+    UnloadAudioStream(stream);
+#else
+    CloseAudioStream(stream);
+#endif
+}
+
+// Queues frameCount frames; 3.0 counts samples over all channels, 4.0 frames
+inline void QueueAudioFrames(AudioStream stream, const void* data, unsigned int frameCount) {
+#ifdef RAYLIB_VERSION
+    UpdateAudioStream(stream, data, static_cast<int>(frameCount));
+#else
+    UpdateAudioStream(stream, data, static_cast<int>(frameCount * stream.channels));
+#endif
+}
+
+// Glyph metrics of a font; 4.0 renamed CharInfo and Font::chars
+#ifdef RAYLIB_VERSION
+typedef GlyphInfo FontGlyph;
+inline const FontGlyph& GetFontGlyph(const Font& font, int index) { return font.glyphs[index]; }
+#else
+typedef CharInfo FontGlyph;
+inline const FontGlyph& GetFontGlyph(const Font& font, int index) { return font.chars[index]; }
+#endif
@@ -1,6 +1,20 @@
 #include "raylib.h"
+#include "client/asset_loader.h"
+#include "client/asset_pack.h"
+#include "client/atlas.h"
+#include "client/ball_renderer.h"
+#include "client/draw_list.h"
+#include "client/frame_pacer.h"
+#include "client/hud_text.h"
+#include "client/layer_cache.h"
+#include "client/music_player.h"
+#include "client/profiler_overlay.h"
+#include "sim/config.h"
+#include "sim/replay.h"
+#include "sim/world.h"
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <vector>
 #include <iostream>
@@ -8,394 +22,350 @@
 enum GameState { INSTRUCTIONS, GAME };
 GameState currentState = INSTRUCTIONS;
 
-class Ball {
-public:
-    int x, y;
-    int xspeed, yspeed;
-    int radius;
-    Color color;
-    bool destroyable; // Flag to check if the ball can be destroyed
-
-    Ball(int maxX, int maxY, int r, Color col, int offsetX = 0, int offsetY = 0) {
-        radius = r;
-        x = radius + rand() % (maxX - 2 * radius - offsetX);  // Adjust for offset
-        y = radius + rand() % (maxY - 2 * radius - offsetY);  // Adjust for offset
-        xspeed = (rand() % 2 == 0 ? 1 : -1) * (5 + rand() % 10);
-        yspeed = (rand() % 2 == 0 ? 1 : -1) * (5 + rand() % 10);
-        color = col;
-        destroyable = false; // Balls are not destroyable by default
-    }
-
-    void draw() const {
-        DrawCircle(x, y, radius, color);
-    }
-
-    void updatePos(int screenWidth, int screenHeight) {
-        x += xspeed;
-        y += yspeed;
-
-        if (x - radius <= 0) {
-            x = radius;
-            xspeed = abs(xspeed);
-        } else if (x + radius >= screenWidth) {
-            x = screenWidth - radius;
-            xspeed = -abs(xspeed);
-        }
-
-        if (y - radius <= 0) {
-            y = radius;
-            yspeed = abs(yspeed);
-        } else if (y + radius >= screenHeight) {
-            y = screenHeight - radius;
-            yspeed = -abs(yspeed);
-        }
-    }
-
-    bool isClicked(Vector2 mousePoint) const {
-        return CheckCollisionPointCircle(mousePoint, {static_cast<float>(x), static_cast<float>(y)}, radius);
-    }
-
-    void adjustSpeed(int speed) {
-        xspeed = (xspeed > 0 ? 1 : -1) * speed;
-        yspeed = (yspeed > 0 ? 1 : -1) * speed;
-    }
-
-    void setDestroyable(bool flag) {
-        destroyable = flag;
-    }
-};
-
-class Hero {
-public:
-    int points;
-    float centerX, centerY, xvelocity, yvelocity;
-    Rectangle heroRect;
-    bool isMoving;
-    bool isFacingRight;
-    Texture2D spriteSheet;
-    int currentFrame;
-    int framesCounter;
-    int framesSpeed;
-
-    Hero(int p, float cX, float cY)
-    : points(p), centerX(cX), centerY(cY), 
-      xvelocity(0), yvelocity(0), isMoving(false), 
-      isFacingRight(true),
-      currentFrame(0), framesCounter(0), framesSpeed(5) {
-        spriteSheet = LoadTexture("assets/scarfy.png");
-        int frameWidth = spriteSheet.width / 6;
-        int frameHeight = spriteSheet.height;
-        
-        heroRect = {
-            cX - frameWidth / 2.0f, 
-            cY - frameHeight / 2.0f, 
-            static_cast<float>(frameWidth),   
-            static_cast<float>(frameHeight)   
-        };
-    }
+const float MAX_FRAME_TIME = 0.25f;  // Clamp long frames so we never spiral catching up
+const char* ASSET_PACK = "assets/assets.pak";  // Built by make pack; optional
+const char* BACKGROUND_SPRITE = "assets/nbg.png";
+const char* HERO_SPRITE = "assets/scarfy.png";
+const char* PROFILE_CSV = "profile.csv";  // Per-frame phase timings, written on exit
+const char* LATENCY_CSV = "latency.csv";  // Input-to-present histogram, written on exit
+const double REPLAY_SEEK_MS = 10000.0;     // Left/right arrow jump while watching a replay
+
+InputState ReadInput() {
+    InputState input;
+    input.up = IsKeyDown(KEY_W);
+    input.down = IsKeyDown(KEY_S);
+    input.left = IsKeyDown(KEY_A);
+    input.right = IsKeyDown(KEY_D);
+    input.mousePressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    Vector2 mousePoint = GetMousePosition();
+    input.mouse = {mousePoint.x, mousePoint.y};
+    return input;
+}
 
-    ~Hero() {
-        UnloadTexture(spriteSheet);
+// Edge inputs seen since the last step are kept until a step consumes them, so a
+// click is neither lost on a frame with no step nor repeated on a frame with two
+void MergeEdges(InputState& pending, const InputState& frame) {
+    if (frame.mousePressed) {
+        pending.mousePressed = true;
+        pending.mouse = frame.mouse;
     }
+    pending.restart = pending.restart || frame.restart;
+    pending.toggleCollisions = pending.toggleCollisions || frame.toggleCollisions;
+}
 
-    void draw() const {
-    int frameWidth = spriteSheet.width / 6;  // Assuming 6 frames in the sprite sheet
-    Rectangle sourceRec = { 
-        static_cast<float>(currentFrame * frameWidth), 0.0f, 
-        static_cast<float>(frameWidth), static_cast<float>(spriteSheet.height) 
+void DrawHero(DrawList& list, const Hero& hero, const TextureAtlas& atlas, float alpha) {
+    Rectangle spriteSheet = atlas.region(HERO_SPRITE);
+    float frameWidth = static_cast<float>(static_cast<int>(spriteSheet.width) / HERO_FRAMES);
+    Rectangle sourceRec = {
+        spriteSheet.x + hero.currentFrame * frameWidth, spriteSheet.y,
+        frameWidth, spriteSheet.height
     };
 
     // Mirror the texture when facing left
-    if (!isFacingRight) {
+    if (!hero.isFacingRight) {
         sourceRec.width = -sourceRec.width;
     }
 
-    // Use heroRect for destination rectangle
-    Rectangle destRec = heroRect;
+    // Use heroRect for destination rectangle, interpolated between simulation steps
+    Rectangle destRec = {
+        lerp(hero.prevRect.x, hero.heroRect.x, alpha),
+        lerp(hero.prevRect.y, hero.heroRect.y, alpha),
+        hero.heroRect.width,
+        hero.heroRect.height
+    };
 
-    // The origin is adjusted to the top-left since heroRect already positions correctly
-    Vector2 origin = { 0.0f, 0.0f };
-    // Draw the texture inside the rectangle
-    DrawTexturePro(spriteSheet, sourceRec, destRec, origin, 0.0f, WHITE);
+    list.add(LAYER_SPRITES, atlas.texture, sourceRec, destRec, WHITE);
 
     // Optional: Draw the red bounding rectangle for debugging
-    // DrawRectangleLinesEx(heroRect, 2, RED);
+    // DrawRectangleLinesEx(destRec, 2, RED);
+}
+
+void ShowInstructions(DrawList& list, int screenWidth, int screenHeight) {
+    // Laid out on the first call, then only redrawn
+    static const HudText title("WELCOME TO >> NO TIME TO DIE!", 40);
+    static const HudText move("Use W, A, S, D to move the hero.", 30);
+    static const HudText avoid("Avoid balls and try to survive!", 30);
+    static const HudText click("Yellow balls can be clicked to destroy.", 30);
+    static const HudText bounce("Press C to make the balls bounce off each other.", 30);
+    static const HudText start("Press ENTER to start!", 30);
+
+    title.draw(list, static_cast<float>(screenWidth / 2 - 350), static_cast<float>(screenHeight / 4), WHITE);
+    move.draw(list, static_cast<float>(screenWidth / 2 - 250), static_cast<float>(screenHeight / 4 + 100), YELLOW);
+    avoid.draw(list, static_cast<float>(screenWidth / 2 - 250), static_cast<float>(screenHeight / 4 + 150), YELLOW);
+    click.drawCentered(list, static_cast<float>(screenWidth / 2), static_cast<float>(screenHeight / 4 + 200), YELLOW);
+    bounce.draw(list, static_cast<float>(screenWidth / 2 - 350), static_cast<float>(screenHeight / 4 + 250), YELLOW);
+    start.draw(list, static_cast<float>(screenWidth / 2 - 200), static_cast<float>(screenHeight / 4 + 300), WHITE);
 }
 
-    void updatePos() {
-        isMoving = false;
 
-        if (IsKeyDown(KEY_W) && heroRect.y > 0) {
-            centerY -= yvelocity;
-            heroRect.y -= yvelocity;
-            isMoving = true;
-        }
-        if (IsKeyDown(KEY_S) && heroRect.y + heroRect.height < GetScreenHeight()) {
-            centerY += yvelocity;
-            heroRect.y += yvelocity;
-            isMoving = true;
-        }
-        if (IsKeyDown(KEY_A) && heroRect.x > 0) {
-            centerX -= xvelocity;
-            heroRect.x -= xvelocity;
-            isMoving = true;
-            isFacingRight = false;
-        }
-        if (IsKeyDown(KEY_D) && heroRect.x + heroRect.width < GetScreenWidth()) {
-            centerX += xvelocity;
-            heroRect.x += xvelocity;
-            isMoving = true;
-            isFacingRight = true;
-        }
+static void Usage() {
+    std::cerr << "usage: game [--seed N] [--record FILE | --replay FILE] [--low-latency]" << std::endl;
+}
 
-        // Update animation frame only when moving
-        if (isMoving) {
-            updateAnimation();
+// game [--seed N] [--record FILE | --replay FILE] [--low-latency]
+int main(int argc, char** argv) {
+    uint64_t seed = static_cast<uint64_t>(time(0));
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    FramePacing pacing = PACING_DEFAULT;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--low-latency") == 0) {
+            pacing = PACING_LOW_LATENCY;
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordFile = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayFile = argv[++i];
         } else {
-            currentFrame = 0;  // Reset to first frame when not moving
+            Usage();
+            return 1;
         }
     }
-
-    void updateAnimation() {
-        framesCounter++;
-        if (framesCounter >= (60 / framesSpeed)) {
-            framesCounter = 0;
-            
-            // Modify animation logic for reversed running when facing left
-            if (isFacingRight) {
-                currentFrame++;
-                if (currentFrame >= 6) {  // Assuming 6 frames in the sprite sheet
-                    currentFrame = 0;
-                }
-            } else {
-                currentFrame--;
-                if (currentFrame < 0) {  // Reverse animation when facing left
-                    currentFrame = 5;
-                }
-            }
-        }
+    if (recordFile && replayFile) {
+        Usage();
+        return 1;
     }
 
-    bool checkCollision(const std::vector<Ball>& balls) {
-        for (const auto& ball : balls) {
-            if (CheckCollisionCircleRec({static_cast<float>(ball.x), static_cast<float>(ball.y)}, 
-                                        ball.radius, heroRect)) {
-                return true;  // Collision detected
-            }
+    ReplayPlayer player;
+    if (replayFile) {
+        if (!player.open(replayFile)) {
+            std::cerr << "Could not read replay " << replayFile << std::endl;
+            return 1;
         }
-        return false;
+        seed = player.getHeader().seed;
+        currentState = GAME;  // A replay starts where the recording did
     }
-};
-
-void ShowInstructions(int screenWidth, int screenHeight) {
-    DrawText("WELCOME TO >> NO TIME TO DIE!", static_cast<float>(screenWidth / 2 - 350), static_cast<float>(screenHeight / 4), 40, WHITE);
-    DrawText("Use W, A, S, D to move the hero.", static_cast<float>(screenWidth / 2 - 250), static_cast<float>(screenHeight / 4 + 100), 30, YELLOW);
-    DrawText("Avoid balls and try to survive!", static_cast<float>(screenWidth / 2 - 250), static_cast<float>(screenHeight / 4 + 150), 30, YELLOW);
-
-    // Calculate the width of the text and center it
-    const char* instructionText = "Yellow balls can be clicked to destroy.";
-    int textWidth = MeasureText(instructionText, 30);
-    DrawText(instructionText, static_cast<float>(screenWidth / 2 - textWidth / 2), static_cast<float>(screenHeight / 4 + 200), 30, YELLOW);
 
-    DrawText("Press ENTER to start!", static_cast<float>(screenWidth / 2 - 200), static_cast<float>(screenHeight / 4 + 300), 30, WHITE);
-}
-
-
-int main() {
-    int score = 0;
-    srand(time(0));
-    const int screenWidth = 1920;
-    const int screenHeight = 1080;
+    const int screenWidth = SCREEN_WIDTH;
+    const int screenHeight = SCREEN_HEIGHT;
 
+    // Render as fast as the display refreshes; the simulation keeps its own fixed rate
+    SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(screenWidth, screenHeight, "No time to die");
     InitAudioDevice();
-    SetTargetFPS(120);
-
-    Texture2D background=LoadTexture("assets/nbg.png");
-    Sound sound = LoadSound("assets/mdmp3.mp3");
-    PlaySound(sound);
-
-    Hero hero(5, screenWidth / 2, screenHeight / 2);
-    hero.xvelocity = 5;
-    hero.yvelocity = 5;
-
-    std::vector<Ball> balls;
-    std::vector<Ball> cornerBalls;
-    double lastTime = GetTime();
-    bool isGameOver = false;
-
-    cornerBalls.push_back(Ball(screenWidth, screenHeight, 20, WHITE, 100, 100)); // Top-left
-    cornerBalls.push_back(Ball(screenWidth, screenHeight, 20, WHITE, 100, 100)); // Bottom-right
+    FramePacer pacer(pacing, GetMonitorRefreshRate(0));
+    if (pacer.getMode() != pacing) {
+        std::cerr << "--low-latency needs GLFW's glfwPollEvents, which this raylib build does not export; using default pacing" << std::endl;
+    }
+    SetTargetFPS(pacer.targetFps());  // Off in low-latency mode, where the pacer sleeps instead
+
+    AssetPack pack;
+    pack.open(ASSET_PACK);
+    // The sprite atlas loads behind the instructions screen; nothing draws from it before the game
+    TextureAtlas atlas = {};
+    AssetLoader loader(pack);
+    loader.addAtlas("atlas", {BACKGROUND_SPRITE, HERO_SPRITE}, &atlas);
+    loader.start();
+    MusicPlayer music;  // Streams from the pack, so it stays open until exit
+    music.load(pack, "assets/mdmp3.mp3");
+    music.play();
+
+    BallRenderer ballRenderer;
+    ballRenderer.load();
+    DrawList drawList;
+    // Holds the instruction text, then the background and the game over screen
+    LayerCache staticLayer;
+    staticLayer.load(screenWidth, screenHeight);
+
+    JobSystem jobs;
+    FrameProfiler profiler;
+    bool showProfiler = false;
+    World world(screenWidth, screenHeight, seed);
+    world.jobs = &jobs;
+    world.profiler = &profiler;
+    float accumulator = 0.0f;
+    InputState pending;
+    ReplayRecorder recorder;
+    bool replayEnded = false;
 
     Rectangle retryButton = {screenWidth / 2 - 100, screenHeight / 2 + 50, 200, 50};
 
-    double stateTime = 0.0;  // Initialize to 0, it will be set when the game starts
-    bool isYellow = false;
-    bool canDelete = false;
+    // HUD strings are re-formatted and laid out only when what they show changes
+    HudText gameOverText("GAME OVER!", 50);
+    HudText retryText("Retry", 30);
+    HudText bouncingText("Bouncing balls", 30);
+    HudText scoreText(30);
+    HudText timeText(30);
 
     while (!WindowShouldClose() && currentState == INSTRUCTIONS) {
+        pacer.begin();
+        music.update();
+        bool loaded = loader.update();
+        // The instructions never change, so they are composed once and then drawn as one quad
+        if (!staticLayer.isValid()) {
+            ShowInstructions(drawList, screenWidth, screenHeight);
+            staticLayer.compose(drawList, BLACK);
+        }
+
         BeginDrawing();
-        ClearBackground(BLACK);
+        ClearBackground(BLACK);  // Glyph edges leave the layer's alpha short of opaque
+        staticLayer.draw(drawList, LAYER_BACKGROUND);
+        drawList.flush();
+        if (!loaded) {
+            DrawText(TextFormat("Loading %i%%", static_cast<int>(loader.progress() * 100)), 20, screenHeight - 50, 20, GRAY);
+        }
 
-        ShowInstructions(screenWidth, screenHeight);
+        if (IsKeyPressed(KEY_C)) {
+            world.ballCollisions = !world.ballCollisions;
+        }
 
         if (IsKeyPressed(KEY_ENTER)) {
             currentState = GAME;
-            stateTime = GetTime();  // Start the game timer after ENTER is pressed
+            world.stateTime = world.simTime;  // Start the game timer after ENTER is pressed
         }
 
+        pacer.beforePresent();
         EndDrawing();
+        pacer.presented();
+    }
+    pacer.resetLatency();  // Only gameplay frames are reported
+    loader.finish();  // Normally done long before ENTER; replays skip the instructions and wait here
+    staticLayer.invalidate();
+
+    // The header is written once the instructions are gone, so it carries the mode picked there
+    if (replayFile) {
+        player.getHeader().apply(world);
+    } else if (recordFile && !recorder.open(recordFile, ReplayHeader::forWorld(world, seed))) {
+        std::cerr << "Could not write " << recordFile << std::endl;
     }
 
     while (!WindowShouldClose()) {
-        if (!isGameOver) {
-            hero.updatePos();
-            int newSpeed = (hero.isMoving) ? 8 : 1;
+        profiler.beginFrame();
+        {
+            ProfileScope scope(&profiler, PROFILE_WAIT);
+            pacer.begin();
+        }
 
-            for (auto& ball : balls) {
-                ball.adjustSpeed(newSpeed);
-            }
-            for (auto& cornerBall : cornerBalls) {
-                cornerBall.adjustSpeed(newSpeed);
+        InputState input;
+        {
+            ProfileScope scope(&profiler, PROFILE_INPUT);
+            input = ReadInput();
+            input.toggleCollisions = IsKeyPressed(KEY_C);
+            input.restart = world.isGameOver && input.mousePressed &&
+                            CheckCollisionPointRec({input.mouse.x, input.mouse.y}, retryButton);
+            MergeEdges(pending, input);
+            if (IsKeyPressed(KEY_F3)) {
+                showProfiler = !showProfiler;
             }
-
-            double currentTime = GetTime();
-            if (currentTime - lastTime >= 3.0 && !isYellow) {
-                balls.push_back(Ball(screenWidth, screenHeight, 20, WHITE));
-                lastTime = currentTime;
+            if (replayFile && (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_RIGHT))) {
+                double jump = IsKeyPressed(KEY_RIGHT) ? REPLAY_SEEK_MS : -REPLAY_SEEK_MS;
+                player.seek(world, player.positionMs() + jump);
+                replayEnded = false;
+                accumulator = 0.0f;
             }
+        }
 
-            if (hero.isMoving) {
-                score++;
-                SetSoundPitch(sound, 1.0f);
+        float frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) {
+            frameTime = MAX_FRAME_TIME;
+        }
+        accumulator += frameTime;
+
+        // Advance the simulation in fixed steps; leftover time is rendered by interpolation
+        while (accumulator >= SIM_DT) {
+            accumulator -= SIM_DT;
+            InputState stepInput = input;
+            if (replayFile) {
+                if (replayEnded || !player.next(stepInput)) {
+                    // Hold on the last step; seeking back starts it playing again
+                    replayEnded = true;
+                    accumulator = 0.0f;
+                    break;
+                }
             } else {
-                SetSoundPitch(sound, 0.8f);
-            }
-
-            for (auto& ball : balls) {
-                ball.updatePos(screenWidth, screenHeight);
-            }
-            for (auto& cornerBall : cornerBalls) {
-                cornerBall.updatePos(screenWidth, screenHeight);
-            }
-
-            if (hero.checkCollision(balls) || hero.checkCollision(cornerBalls)) {
-                isGameOver = true;
+                stepInput.mousePressed = pending.mousePressed;
+                stepInput.mouse = pending.mousePressed ? pending.mouse : input.mouse;
+                stepInput.restart = pending.restart;
+                stepInput.toggleCollisions = pending.toggleCollisions;
+                pending = InputState();
             }
+            recorder.record(world, stepInput);
+            world.step(stepInput);
         }
+        float alpha = replayEnded ? 1.0f : accumulator / SIM_DT;
 
-        if (GetTime() - stateTime >= 10.0 && !isYellow) {
-            isYellow = true;
-            canDelete = true;
-            for (auto& ball : balls) {
-                ball.color = YELLOW;
-                ball.setDestroyable(true);
-            }
-            for (auto& cornerBall : cornerBalls) {
-                cornerBall.color = YELLOW;
-                cornerBall.setDestroyable(true);
-            }
-            stateTime = GetTime();
+        if (!world.isGameOver) {
+            music.setPitch(world.hero.isMoving ? 1.0f : 0.8f);
         }
-
-        if (GetTime() - stateTime >= 3.0 && isYellow) {
-            for (auto& ball : balls) {
-                ball.color = WHITE;
-                ball.setDestroyable(false);
-            }
-            for (auto& cornerBall : cornerBalls) {
-                cornerBall.color = WHITE;
-                cornerBall.setDestroyable(false);
+        music.update();
+
+        {
+            ProfileScope scope(&profiler, PROFILE_DRAW);
+            scoreText.set("Score: %i", world.score);
+
+            // The background is static while playing; once the game ends the whole
+            // screen is, until the score shown on it changes or the game restarts
+            staticLayer.invalidateUnless(world.isGameOver ? (static_cast<unsigned long long>(world.score) << 1) | 1 : 0);
+            if (!staticLayer.isValid()) {
+                Rectangle background = atlas.region(BACKGROUND_SPRITE);
+                drawList.add(LAYER_BACKGROUND, atlas.texture, background, {0.0f, 0.0f, background.width, background.height}, WHITE);
+                if (world.isGameOver) {
+                    gameOverText.drawCentered(drawList, screenWidth / 2, screenHeight / 2 - 100, RED);
+                    scoreText.drawCentered(drawList, screenWidth / 2, screenHeight / 2, WHITE);
+
+                    // Retry button rectangle, clicks on it restart the world on the next step
+                    drawList.add(LAYER_HUD_SHAPES, atlas.texture, atlas.whiteTexel(), retryButton, DARKGREEN);
+                    retryText.drawCentered(drawList, screenWidth / 2, screenHeight / 2 + 60, WHITE);
+                }
+                staticLayer.compose(drawList, BLACK);
             }
-            isYellow = false;
-            canDelete = false;
-            stateTime = GetTime();
-            balls.push_back(Ball(screenWidth, screenHeight, 20, WHITE));
-        }
 
-        if (canDelete) {
-            Vector2 mousePoint = GetMousePosition();
-            for (auto it = balls.begin(); it != balls.end();) {
-                if (it->isClicked(mousePoint) && it->destroyable && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    it = balls.erase(it);
-                    score += 100;
-                } else {
-                    ++it;
+            BeginDrawing();
+            ClearBackground(BLACK);
+            staticLayer.draw(drawList, LAYER_BACKGROUND);
+            if (!world.isGameOver) {
+                ballRenderer.draw(drawList, atlas, world.balls, alpha, world.isYellow);
+                DrawHero(drawList, world.hero, atlas, alpha);
+
+                // Rounded to what is shown, so the text only changes when a digit does
+                timeText.set("Time: %.2f", std::round((world.simTime - world.stateTime) * 100.0) / 100.0);
+                scoreText.draw(drawList, 20, 20, WHITE);
+                timeText.draw(drawList, 20, 60, WHITE);
+                if (world.ballCollisions) {
+                    bouncingText.draw(drawList, 20, 100, YELLOW);
                 }
             }
-            for (auto it = cornerBalls.begin(); it != cornerBalls.end();) {
-                if (it->isClicked(mousePoint) && it->destroyable && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    it = cornerBalls.erase(it);
-                    score += 5000;
-                } else {
-                    ++it;
-                }
+            drawList.flush();
+
+            // Debug text stays immediate, on top of everything
+            if (replayFile) {
+                DrawText(TextFormat("Replay %.1f / %.1f s%s  (LEFT/RIGHT to seek)",
+                                    player.positionMs() / 1000.0, player.durationMs() / 1000.0,
+                                    replayEnded ? " ended" : ""),
+                         20, screenHeight - 50, 30, LIGHTGRAY);
             }
-        }
-
-        BeginDrawing();
-        ClearBackground(BLACK);
-        DrawTexture(background, 0, 0, WHITE);
-
-        if (isGameOver) {
-    // GAME OVER text
-    const char* gameOverText = "GAME OVER!";
-    int gameOverWidth = MeasureText(gameOverText, 50);
-    DrawText(gameOverText, screenWidth / 2 - gameOverWidth / 2, screenHeight / 2 - 100, 50, RED);
-
-    // Score text
-    const char* scoreText = TextFormat("Score: %i", score);
-    int scoreWidth = MeasureText(scoreText, 30);
-    DrawText(scoreText, screenWidth / 2 - scoreWidth / 2, screenHeight / 2, 30, WHITE);
-
-    // Retry button and text
-    if (CheckCollisionPointRec(GetMousePosition(), retryButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        // Reset the game state
-        isGameOver = false;
-        score = 0;
-
-        // Clear existing balls and recreate corner balls
-        balls.clear();
-        cornerBalls.clear();
-        cornerBalls.push_back(Ball(screenWidth, screenHeight, 20, WHITE, 100, 100)); // Top-left
-        cornerBalls.push_back(Ball(screenWidth, screenHeight, 20, WHITE, 100, 100)); // Bottom-right
-
-        // Reset hero position and states
-        hero.centerX = screenWidth / 2;
-        hero.centerY = screenHeight / 2;
-        hero.heroRect.x = screenWidth / 2 - hero.heroRect.width / 2;
-        hero.heroRect.y = screenHeight / 2 - hero.heroRect.height / 2;
-        stateTime = GetTime();
-        isYellow = false;
-        canDelete = false;
-    }
 
-    // Retry button rectangle
-    DrawRectangleRec(retryButton, DARKGREEN);
-
-    // Retry text
-    const char* retryText = "Retry";
-    int retryWidth = MeasureText(retryText, 30);
-    DrawText(retryText, screenWidth / 2 - retryWidth / 2, screenHeight / 2 + 60, 30, WHITE);
-
-        } else {
-            for (const auto& ball : balls) {
-                ball.draw();
+            if (showProfiler) {
+                DrawProfilerOverlay(profiler, pacer, drawList.lastBatches(), screenWidth - 420, 20);
             }
-            for (const auto& cornerBall : cornerBalls) {
-                cornerBall.draw();
-            }
-            hero.draw();
+        }
 
-            DrawText(TextFormat("Score: %i", score), 20, 20, 30, WHITE);
-            DrawText(TextFormat("Time: %.2f", GetTime() - stateTime), 20, 60, 30, WHITE);
+        {
+            ProfileScope scope(&profiler, PROFILE_PRESENT);
+            pacer.beforePresent();
+            EndDrawing();
+            pacer.presented();
         }
+        profiler.endFrame();
+    }
 
-        EndDrawing();
+    if (profiler.frameCount() > 0 && !profiler.writeCsv(PROFILE_CSV)) {
+        std::cerr << "Could not write " << PROFILE_CSV << std::endl;
+    }
+    if (pacer.latency().count() > 0 && !pacer.latency().writeCsv(LATENCY_CSV)) {
+        std::cerr << "Could not write " << LATENCY_CSV << std::endl;
+    }
+    if (!recorder.close()) {
+        std::cerr << "Could not write " << recordFile << std::endl;
     }
 
-    UnloadSound(sound);
-    UnloadTexture(background);
+    staticLayer.unload();
+    ballRenderer.unload();
+    music.unload();
+    pack.close();
+    UnloadTexture(atlas.texture);
     CloseAudioDevice();
     CloseWindow();
     return 0;
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Cache-line aligned storage for the structure-of-arrays systems, so each array
+// starts on its own line and vector loads never straddle the first one.
+const std::size_t CACHE_LINE = 64;
+
+template <class T>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(CACHE_LINE));
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
@@ -0,0 +1,161 @@
+#include "ball_collisions.h"
+#include <algorithm>
+#include <cmath>
+
+BallCollider::BallCollider()
+: layoutVersion(0), pairsTested(0) {}
+
+// Brings the order up to date with the ball set. Returns true when it needs a
+// full sort rather than an insertion pass.
+bool BallCollider::syncOrder(const BallSystem& balls) {
+    int count = balls.size();
+    bool fullSort = order.empty();
+    if (layoutVersion != balls.getLayoutVersion()) {
+        // Removals swap the last ball into the freed slot, so dropping indices past
+        // the end leaves each live index exactly once; moved balls sit out of place
+        // until the insertion pass below walks them home.
+        order.erase(std::remove_if(order.begin(), order.end(), [count](int i) { return i >= count; }),
+                    order.end());
+        layoutVersion = balls.getLayoutVersion();
+    }
+    // Spawns only append, so a few new balls join at the end and insertion sort places them
+    int added = count - static_cast<int>(order.size());
+    if (added > MAX_INSERTED) {
+        fullSort = true;
+    }
+    for (int i = static_cast<int>(order.size()); i < count; i++) {
+        order.push_back(i);
+    }
+    return fullSort;
+}
+
+void BallCollider::save(ByteWriter& out, const BallSystem& balls) const {
+    out.put<uint8_t>(layoutVersion == balls.getLayoutVersion());
+    out.put<int32_t>(static_cast<int32_t>(order.size()));
+    out.putArray(order, order.size());
+}
+
+bool BallCollider::load(ByteReader& in, const BallSystem& balls) {
+    bool synced = in.get<uint8_t>() != 0;
+    int size = in.get<int32_t>();
+    if (!in.ok() || size < 0 || static_cast<size_t>(size) > in.remaining()) {
+        return false;
+    }
+    in.getArray(order, size);
+    // An order saved mid layout change still needs its stale indices filtered out
+    layoutVersion = synced ? balls.getLayoutVersion() : balls.getLayoutVersion() - 1;
+    return in.ok() && std::all_of(order.begin(), order.end(), [](int i) { return i >= 0; });
+}
+
+int BallCollider::resolve(BallSystem& balls, JobSystem* jobs, float axisSpeed) {
+    int count = balls.size();
+    bool fullSort = syncOrder(balls);
+
+    minX.resize(count);
+    maxX.resize(count);
+    ParallelFor(jobs, count, SWEEP_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float px = balls.posX(i);
+            minX[i] = px - balls.radius[i];
+            maxX[i] = px + balls.radius[i];
+        }
+    });
+
+    if (fullSort) {
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return minX[a] < minX[b]; });
+    } else {
+        for (int k = 1; k < count; k++) {
+            int ball = order[k];
+            float key = minX[ball];
+            int j = k - 1;
+            while (j >= 0 && minX[order[j]] > key) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = ball;
+        }
+    }
+
+    // Overlap tests only read positions, so they run in parallel over slices of
+    // the sweep. Responses are applied afterwards in sweep order on this thread,
+    // which keeps results identical for any number of threads.
+    int chunks = (count + SWEEP_GRAIN - 1) / SWEEP_GRAIN;
+    if (static_cast<int>(chunkContacts.size()) < chunks) {
+        chunkContacts.resize(chunks);
+        chunkPairs.resize(chunks);
+    }
+    ParallelFor(jobs, count, SWEEP_GRAIN, [&](int begin, int end) {
+        int chunk = begin / SWEEP_GRAIN;
+        chunkContacts[chunk].clear();
+        chunkPairs[chunk] = findContacts(balls, begin, end, chunkContacts[chunk]);
+    });
+
+    int contacts = 0;
+    pairsTested = 0;
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        pairsTested += chunkPairs[chunk];
+        for (const Contact& contact : chunkContacts[chunk]) {
+            contacts += bounce(balls, contact) ? 1 : 0;
+        }
+    }
+    // Only after every bounce, so a ball in two contacts sees the first impulse in full
+    if (axisSpeed > 0.0f) {
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            for (const Contact& contact : chunkContacts[chunk]) {
+                balls.setAxisSpeed(contact.a, axisSpeed);
+                balls.setAxisSpeed(contact.b, axisSpeed);
+            }
+        }
+    }
+    return contacts;
+}
+
+int BallCollider::findContacts(const BallSystem& balls, int begin, int end, std::vector<Contact>& out) const {
+    int count = balls.size();
+    int tested = 0;
+    for (int k = begin; k < end; k++) {
+        int a = order[k];
+        float ax = balls.posX(a);
+        float ay = balls.posY(a);
+        float ra = balls.radius[a];
+        for (int m = k + 1; m < count && minX[order[m]] <= maxX[a]; m++) {
+            int b = order[m];
+            tested++;
+            float reach = ra + balls.radius[b];
+            float nx = balls.posX(b) - ax;
+            float ny = balls.posY(b) - ay;
+            float distSq = nx * nx + ny * ny;
+            if (distSq <= reach * reach && distSq != 0.0f) {
+                out.push_back({a, b});
+            }
+        }
+    }
+    return tested;
+}
+
+bool BallCollider::bounce(BallSystem& balls, const Contact& contact) {
+    int a = contact.a;
+    int b = contact.b;
+    float nx = balls.posX(b) - balls.posX(a);
+    float ny = balls.posY(b) - balls.posY(a);
+    float dist = sqrtf(nx * nx + ny * ny);
+    nx /= dist;
+    ny /= dist;
+    // Closing speed along the contact normal; separating pairs are left alone
+    float closing = (balls.vx[a] - balls.vx[b]) * nx + (balls.vy[a] - balls.vy[b]) * ny;
+    if (closing <= 0.0f) {
+        return false;
+    }
+
+    // Masses proportional to area
+    float ra = balls.radius[a];
+    float rb = balls.radius[b];
+    float ma = ra * ra;
+    float mb = rb * rb;
+    float impulse = 2.0f * closing / (ma + mb);
+    balls.vx[a] -= impulse * mb * nx;
+    balls.vy[a] -= impulse * mb * ny;
+    balls.vx[b] += impulse * ma * nx;
+    balls.vy[b] += impulse * ma * ny;
+    return true;
+}
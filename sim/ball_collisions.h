@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ball_system.h"
+#include "byte_io.h"
+#include "job_system.h"
+#include <vector>
+
+// Elastic ball-ball collisions. Broadphase is sort-and-sweep along x: the ball
+// order from the previous step is re-sorted with insertion sort, which is close
+// to linear because balls barely move between steps. Candidate pairs whose x
+// extents overlap then get an exact circle-circle test.
+class BallCollider {
+public:
+    BallCollider();
+
+    // Bounces every touching, approaching pair. Returns the number of contacts.
+    // With axisSpeed set, balls that touched keep only the new direction of travel
+    // and leave at axisSpeed per axis, like every other ball.
+    int resolve(BallSystem& balls, JobSystem* jobs = nullptr, float axisSpeed = 0.0f);
+
+    int lastPairsTested() const { return pairsTested; }
+
+    // The sweep order decides which of two simultaneous contacts is applied first,
+    // so replay keyframes carry it rather than re-sorting on load
+    void save(ByteWriter& out, const BallSystem& balls) const;
+    bool load(ByteReader& in, const BallSystem& balls);
+
+private:
+    static const int MAX_INSERTED = 64;  // More new balls than this in one step get a full sort
+    static const int SWEEP_GRAIN = 2048; // Sweep positions per job
+
+    struct Contact {
+        int a, b;
+    };
+
+    std::vector<int> order;    // Ball indices sorted by left edge, kept between steps
+    std::vector<float> minX;   // Left edge of each ball, by ball index
+    std::vector<float> maxX;
+    unsigned layoutVersion;    // BallSystem layout the order was built for
+    int pairsTested;
+    std::vector<std::vector<Contact>> chunkContacts;  // Overlapping pairs found by each job
+    std::vector<int> chunkPairs;                      // Pairs each job tested
+
+    bool syncOrder(const BallSystem& balls);
+    int findContacts(const BallSystem& balls, int begin, int end, std::vector<Contact>& out) const;
+    static bool bounce(BallSystem& balls, const Contact& contact);
+};
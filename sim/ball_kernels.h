@@ -0,0 +1,34 @@
+#pragma once
+
+// Integrate-and-reflect kernels for BallSystem's float positions. Every variant
+// performs the same float operations in the same order as the scalar one, so
+// results are bit-identical whichever instruction set is picked at runtime.
+
+enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512,
+};
+
+struct BallArrays {
+    float* x;
+    float* y;
+    float* prevX;
+    float* prevY;
+    float* vx;
+    float* vy;
+    const float* radius;
+};
+
+typedef void (*IntegrateKernel)(const BallArrays& balls, int begin, int end,
+                                float dt, float width, float height);
+
+// Highest level both compiled in and supported by this CPU
+SimdLevel DetectSimdLevel();
+// Falls back to the next lower level when the requested one is unavailable
+IntegrateKernel GetIntegrateKernel(SimdLevel level);
+SimdLevel ClampSimdLevel(SimdLevel level);
+const char* SimdLevelName(SimdLevel level);
+// Inverse of SimdLevelName; false, leaving level as it was, for an unknown name
+bool ParseSimdLevel(const char* name, SimdLevel& level);
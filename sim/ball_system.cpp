@@ -0,0 +1,284 @@
+#include "ball_system.h"
+#include <algorithm>
+
+BallSystem::BallSystem(bool quantizedPositions)
+: count(0), reserved(0), layoutVersion(0), quantized(quantizedPositions) {
+    setSimdLevel(DetectSimdLevel());
+}
+
+void BallSystem::setSimdLevel(SimdLevel level) {
+    simdLevel = ClampSimdLevel(level);
+    integrateKernel = GetIntegrateKernel(simdLevel);
+}
+
+uint16_t BallSystem::quantize(float v) {
+    float q = v * QUANT_SCALE + 0.5f;
+    if (q <= 0.0f) {
+        return 0;
+    }
+    if (q >= 65535.0f) {
+        return 65535;
+    }
+    return static_cast<uint16_t>(q);
+}
+
+void BallSystem::reserve(int balls) {
+    if (balls <= reserved) {
+        return;
+    }
+    if (quantized) {
+        qx.reserve(balls);
+        qy.reserve(balls);
+        prevQx.reserve(balls);
+        prevQy.reserve(balls);
+    } else {
+        x.reserve(balls);
+        y.reserve(balls);
+        prevX.reserve(balls);
+        prevY.reserve(balls);
+    }
+    vx.reserve(balls);
+    vy.reserve(balls);
+    radius.reserve(balls);
+    kind.reserve(balls);
+    denseSlot.reserve(balls);
+    slotDense.reserve(balls);
+    slotGeneration.reserve(balls);
+    freeSlots.reserve(balls);
+    reserved = balls;
+}
+
+void BallSystem::setQuantized(bool on) {
+    if (on == quantized) {
+        return;
+    }
+    if (on) {
+        qx.reserve(reserved);
+        qy.reserve(reserved);
+        prevQx.reserve(reserved);
+        prevQy.reserve(reserved);
+        qx.resize(count);
+        qy.resize(count);
+        prevQx.resize(count);
+        prevQy.resize(count);
+        for (int i = 0; i < count; i++) {
+            qx[i] = quantize(x[i]);
+            qy[i] = quantize(y[i]);
+            prevQx[i] = quantize(prevX[i]);
+            prevQy[i] = quantize(prevY[i]);
+        }
+        x.clear();
+        y.clear();
+        prevX.clear();
+        prevY.clear();
+    } else {
+        x.reserve(reserved);
+        y.reserve(reserved);
+        prevX.reserve(reserved);
+        prevY.reserve(reserved);
+        x.resize(count);
+        y.resize(count);
+        prevX.resize(count);
+        prevY.resize(count);
+        for (int i = 0; i < count; i++) {
+            x[i] = dequantize(qx[i]);
+            y[i] = dequantize(qy[i]);
+            prevX[i] = dequantize(prevQx[i]);
+            prevY[i] = dequantize(prevQy[i]);
+        }
+        qx.clear();
+        qy.clear();
+        prevQx.clear();
+        prevQy.clear();
+    }
+    quantized = on;
+}
+
+uint32_t BallSystem::allocateSlot(int dense) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotDense[slot] = dense;
+    } else {
+        slot = static_cast<uint32_t>(slotDense.size());
+        slotDense.push_back(dense);
+        slotGeneration.push_back(1);
+    }
+    return slot;
+}
+
+void BallSystem::freeSlot(uint32_t slot) {
+    slotDense[slot] = -1;
+    slotGeneration[slot]++;
+    freeSlots.push_back(slot);
+}
+
+int BallSystem::indexOf(BallHandle handle) const {
+    if (handle.slot >= slotGeneration.size() || slotGeneration[handle.slot] != handle.generation) {
+        return -1;
+    }
+    return slotDense[handle.slot];
+}
+
+BallHandle BallSystem::spawn(float px, float py, float xspeed, float yspeed, float r, uint8_t ballKind) {
+    if (count == reserved) {
+        reserve(std::max(reserved * 2, reserved + GROW_CHUNK));
+    }
+    if (quantized) {
+        qx.push_back(quantize(px));
+        qy.push_back(quantize(py));
+        prevQx.push_back(qx.back());
+        prevQy.push_back(qy.back());
+    } else {
+        x.push_back(px);
+        y.push_back(py);
+        prevX.push_back(px);
+        prevY.push_back(py);
+    }
+    vx.push_back(xspeed);
+    vy.push_back(yspeed);
+    radius.push_back(r);
+    kind.push_back(ballKind);
+    uint32_t slot = allocateSlot(count);
+    denseSlot.push_back(slot);
+    count++;
+    return {slot, slotGeneration[slot]};
+}
+
+template <class V>
+static void swapAndPop(V& v, int i) {
+    v[i] = v.back();
+    v.pop_back();
+}
+
+void BallSystem::remove(int i) {
+    if (quantized) {
+        swapAndPop(qx, i);
+        swapAndPop(qy, i);
+        swapAndPop(prevQx, i);
+        swapAndPop(prevQy, i);
+    } else {
+        swapAndPop(x, i);
+        swapAndPop(y, i);
+        swapAndPop(prevX, i);
+        swapAndPop(prevY, i);
+    }
+    swapAndPop(vx, i);
+    swapAndPop(vy, i);
+    swapAndPop(radius, i);
+    swapAndPop(kind, i);
+
+    uint32_t slot = denseSlot[i];
+    swapAndPop(denseSlot, i);
+    if (i < count - 1) {
+        slotDense[denseSlot[i]] = i;
+    }
+    freeSlot(slot);
+    count--;
+    layoutVersion++;
+}
+
+void BallSystem::clear() {
+    for (uint32_t slot : denseSlot) {
+        freeSlot(slot);
+    }
+    denseSlot.clear();
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    qx.clear();
+    qy.clear();
+    prevQx.clear();
+    prevQy.clear();
+    vx.clear();
+    vy.clear();
+    radius.clear();
+    kind.clear();
+    count = 0;
+    layoutVersion++;
+}
+
+void BallSystem::save(ByteWriter& out) const {
+    out.put<uint8_t>(quantized);
+    out.put<int32_t>(count);
+    if (quantized) {
+        out.putArray(qx, count);
+        out.putArray(qy, count);
+        out.putArray(prevQx, count);
+        out.putArray(prevQy, count);
+    } else {
+        out.putArray(x, count);
+        out.putArray(y, count);
+        out.putArray(prevX, count);
+        out.putArray(prevY, count);
+    }
+    out.putArray(vx, count);
+    out.putArray(vy, count);
+    out.putArray(radius, count);
+    out.putArray(kind, count);
+}
+
+bool BallSystem::load(ByteReader& in) {
+    bool quantizedPositions = in.get<uint8_t>() != 0;
+    int balls = in.get<int32_t>();
+    if (!in.ok() || balls < 0 || static_cast<size_t>(balls) > in.remaining()) {
+        return false;
+    }
+    clear();
+    setQuantized(quantizedPositions);
+    reserve(balls);
+    // Spawning placeholders sets up the slot map; the arrays are overwritten below
+    for (int i = 0; i < balls; i++) {
+        spawn(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0);
+    }
+    if (quantized) {
+        in.getArray(qx, count);
+        in.getArray(qy, count);
+        in.getArray(prevQx, count);
+        in.getArray(prevQy, count);
+    } else {
+        in.getArray(x, count);
+        in.getArray(y, count);
+        in.getArray(prevX, count);
+        in.getArray(prevY, count);
+    }
+    in.getArray(vx, count);
+    in.getArray(vy, count);
+    in.getArray(radius, count);
+    in.getArray(kind, count);
+    return in.ok();
+}
+
+void BallSystem::integrate(float dt, int screenWidth, int screenHeight, JobSystem* jobs) {
+    float width = static_cast<float>(screenWidth);
+    float height = static_cast<float>(screenHeight);
+    // Balls are independent, so chunks can run on any thread in any order
+    ParallelFor(jobs, count, INTEGRATE_GRAIN, [&](int begin, int end) {
+        if (quantized) {
+            integrateQuantized(dt, width, height, begin, end);
+        } else {
+            integrateFloat(dt, width, height, begin, end);
+        }
+    });
+}
+
+void BallSystem::integrateFloat(float dt, float width, float height, int begin, int end) {
+    BallArrays arrays = {x.data(), y.data(), prevX.data(), prevY.data(), vx.data(), vy.data(), radius.data()};
+    integrateKernel(arrays, begin, end, dt, width, height);
+}
+
+void BallSystem::integrateQuantized(float dt, float width, float height, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        prevQx[i] = qx[i];
+        prevQy[i] = qy[i];
+        qx[i] = quantize(reflect(dequantize(qx[i]) + vx[i] * dt, vx[i], radius[i], width));
+        qy[i] = quantize(reflect(dequantize(qy[i]) + vy[i] * dt, vy[i], radius[i], height));
+    }
+}
+
+void BallSystem::setAxisSpeed(int i, float speed) {
+    vx[i] = (vx[i] > 0 ? 1 : -1) * speed;
+    vy[i] = (vy[i] > 0 ? 1 : -1) * speed;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "aligned.h"
+#include "ball_kernels.h"
+#include "byte_io.h"
+#include "job_system.h"
+#include "geometry.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Stable reference to a ball. Dense indices change when other balls are removed;
+// a handle keeps naming the same ball and goes stale once that ball is destroyed.
+// Generations start at 1, so a zero-initialised handle is never valid.
+struct BallHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// All balls in structure-of-arrays form. Each pass streams only the arrays it
+// needs: integration reads positions, velocities and radii, collision reads
+// positions and radii, scoring reads kinds. Every kind of ball shares the arrays
+// and passes; what a kind means is data in BALL_KINDS (config.h).
+//
+// In quantized mode positions are stored as 16-bit fixed point (1/QUANT_SCALE px)
+// instead of floats, halving the position footprint for very large ball counts.
+//
+// Storage is a pool: arrays are reserved up front and grow by whole chunks only
+// when full, and handle slots are recycled through a free list, so spawning in
+// play never reallocates.
+class BallSystem {
+public:
+    static constexpr float QUANT_SCALE = 32.0f;  // 65535 / 32 covers a 2047 px playfield
+    static const int INTEGRATE_GRAIN = 8192;     // Balls per job, a multiple of every SIMD width
+    static const int GROW_CHUNK = 1024;          // Least capacity added when the pool is full; it doubles past that
+
+    AlignedVector<float> x, y;
+    AlignedVector<float> prevX, prevY;  // Position at the previous simulation step, for interpolation
+    AlignedVector<uint16_t> qx, qy;     // Quantized mode positions
+    AlignedVector<uint16_t> prevQx, prevQy;
+    AlignedVector<float> vx, vy;
+    AlignedVector<float> radius;
+    AlignedVector<uint8_t> kind;        // BallKind
+
+    explicit BallSystem(bool quantized = false);
+
+    int size() const { return count; }
+    int capacity() const { return reserved; }
+    void reserve(int balls);
+    unsigned getLayoutVersion() const { return layoutVersion; }  // Bumped whenever indices shift
+    bool isQuantized() const { return quantized; }
+    void setQuantized(bool on);
+    SimdLevel getSimdLevel() const { return simdLevel; }
+    void setSimdLevel(SimdLevel level);  // Defaults to the best level the CPU supports
+
+    BallHandle spawn(float px, float py, float xspeed, float yspeed, float r, uint8_t ballKind);
+    void remove(int i);  // O(1): the last ball moves into index i
+    void clear();
+
+    // Every ball in dense order, for replay keyframes. Handles are not kept: a loaded
+    // system hands out fresh ones, and nothing in the simulation outlives a step with one.
+    void save(ByteWriter& out) const;
+    bool load(ByteReader& in);
+
+    BallHandle handleAt(int i) const { return {denseSlot[i], slotGeneration[denseSlot[i]]}; }
+    int indexOf(BallHandle handle) const;  // -1 once the ball is gone
+    bool isAlive(BallHandle handle) const { return indexOf(handle) >= 0; }
+
+    // Velocities are in ball time; the caller scales dt to speed the whole system up
+    // or slow it down, rather than rewriting every velocity
+    void integrate(float dt, int screenWidth, int screenHeight, JobSystem* jobs = nullptr);
+    void setAxisSpeed(int i, float speed);  // Keeps the signs, so the direction survives
+
+    float posX(int i) const { return quantized ? dequantize(qx[i]) : x[i]; }
+    float posY(int i) const { return quantized ? dequantize(qy[i]) : y[i]; }
+    float prevPosX(int i) const { return quantized ? dequantize(prevQx[i]) : prevX[i]; }
+    float prevPosY(int i) const { return quantized ? dequantize(prevQy[i]) : prevY[i]; }
+
+    static uint16_t quantize(float v);
+    static float dequantize(uint16_t q) { return q / QUANT_SCALE; }
+
+private:
+    int count;
+    int reserved;
+    unsigned layoutVersion;
+    std::vector<uint32_t> denseSlot;       // Slot of each ball, parallel to the arrays above
+    std::vector<int> slotDense;            // Dense index of each slot, -1 when free
+    std::vector<uint32_t> slotGeneration;  // Bumped each time the slot is freed
+    std::vector<uint32_t> freeSlots;
+
+    uint32_t allocateSlot(int dense);
+    void freeSlot(uint32_t slot);
+    bool quantized;
+    SimdLevel simdLevel;
+    IntegrateKernel integrateKernel;
+
+    void integrateFloat(float dt, float width, float height, int begin, int end);
+    void integrateQuantized(float dt, float width, float height, int begin, int end);
+};
+
+// Wall reflection shared by every integration path. Returns the new position and
+// flips the speed towards the playfield when the ball touches an edge.
+inline float reflect(float p, float& speed, float r, float extent) {
+    if (p - r <= 0) {
+        speed = fabsf(speed);
+        return r;
+    } else if (p + r >= extent) {
+        speed = -fabsf(speed);
+        return extent - r;
+    }
+    return p;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Little-endian encoding for replay files, independent of the host byte order so
+// logs move between machines. Floats travel as their IEEE bit patterns.
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<unsigned char>& buffer) : out(buffer) {}
+
+    template <class T>
+    void put(T value) {
+        static_assert(std::is_arithmetic<T>::value, "ByteWriter::put takes numbers");
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<unsigned char>(bits >> (8 * i)));
+        }
+    }
+
+    // LEB128, for counts that are almost always small
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    template <class Vector>
+    void putArray(const Vector& values, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            put(values[i]);
+        }
+    }
+
+    void putBytes(const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        out.insert(out.end(), p, p + bytes);
+    }
+
+    size_t size() const { return out.size(); }
+
+private:
+    std::vector<unsigned char>& out;
+};
+
+// Reads what ByteWriter wrote. Running past the end yields zeros and clears ok(),
+// so callers check once after a batch of reads instead of after every field.
+class ByteReader {
+public:
+    ByteReader(const unsigned char* data, size_t bytes) : p(data), end(data + bytes), valid(true) {}
+
+    template <class T>
+    T get() {
+        static_assert(std::is_arithmetic<T>::value, "ByteReader::get returns numbers");
+        T value = T();
+        if (!has(sizeof(T))) {
+            return value;
+        }
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bits |= static_cast<uint64_t>(*p++) << (8 * i);
+        }
+        memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!has(1)) {
+                return 0;
+            }
+            unsigned char byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        valid = false;
+        return 0;
+    }
+
+    template <class Vector>
+    void getArray(Vector& values, size_t count) {
+        typedef typename Vector::value_type T;
+        values.resize(count);
+        for (size_t i = 0; i < count && valid; i++) {
+            values[i] = get<T>();
+        }
+    }
+
+    bool getBytes(void* data, size_t bytes) {
+        if (!has(bytes)) {
+            return false;
+        }
+        memcpy(data, p, bytes);
+        p += bytes;
+        return true;
+    }
+
+    void skip(size_t bytes) {
+        if (has(bytes)) {
+            p += bytes;
+        }
+    }
+
+    const unsigned char* position() const { return p; }
+    size_t remaining() const { return static_cast<size_t>(end - p); }
+    bool ok() const { return valid; }
+
+private:
+    const unsigned char* p;
+    const unsigned char* end;
+    bool valid;
+
+    bool has(size_t bytes) {
+        if (!valid || remaining() < bytes) {
+            valid = false;
+            return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+// Shared tuning constants for the simulation. Nothing in sim/ depends on raylib,
+// so these are the only place the game and the headless driver agree on sizes.
+
+const int SCREEN_WIDTH = 1920;
+const int SCREEN_HEIGHT = 1080;
+
+// Simulation runs at a fixed rate, independent of the render frame rate.
+// All speeds below are in pixels per second.
+const int SIM_HZ = 60;
+const float SIM_DT = 1.0f / SIM_HZ;
+
+const float BALL_MOVING_SPEED = 960.0f;
+const float BALL_IDLE_SPEED = 120.0f;
+const int BALL_RADIUS = 20;
+const int CORNER_BALL_OFFSET = 100;
+const int BALL_POOL_CAPACITY = 4096;    // Reserved at start; far more than a normal game spawns
+
+const float HERO_SPEED = 600.0f;
+const int HERO_FRAMES = 6;              // Frames in assets/scarfy.png
+const float HERO_FRAME_WIDTH = 128.0f;  // scarfy.png is 768x128
+const float HERO_FRAME_HEIGHT = 128.0f;
+
+const int SCORE_PER_SECOND = 120;
+const int BALL_SCORE = 100;
+const int CORNER_BALL_SCORE = 5000;
+
+// Kinds of ball. They share one set of arrays and every pass over them; a new
+// kind is an enum value and a row in BALL_KINDS, not another loop.
+enum BallKind : unsigned char {
+    BALL_REGULAR,
+    BALL_CORNER,  // Spawned away from the edges, worth far more
+    BALL_KIND_COUNT
+};
+
+struct BallKindInfo {
+    int spawnOffset;  // Kept this much further off the right and bottom edges
+    int score;        // For destroying one
+    int perRound;     // Spawned at the start of every round
+};
+
+const BallKindInfo BALL_KINDS[BALL_KIND_COUNT] = {
+    {0, BALL_SCORE, 0},                          // BALL_REGULAR
+    {CORNER_BALL_OFFSET, CORNER_BALL_SCORE, 2},  // BALL_CORNER
+};
+
+const double SPAWN_INTERVAL = 3.0;      // Seconds between new balls outside the yellow phase
+const double WHITE_PHASE_TIME = 10.0;
+const double YELLOW_PHASE_TIME = 3.0;
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cmath>
+#include <initializer_list>
+
+// Minimal geometry types so the simulation does not need raylib's Vector2/Rectangle.
+// Layouts match raylib's, the renderer converts field by field.
+
+struct Vec2 {
+    float x, y;
+};
+
+struct Rect {
+    float x, y, width, height;
+};
+
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Same results as raylib's CheckCollisionPointCircle
+inline bool pointInCircle(Vec2 point, Vec2 center, float radius) {
+    float dx = point.x - center.x;
+    float dy = point.y - center.y;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+// Circle vs axis-aligned rectangle, via the closest point on the rectangle
+inline bool circleRectOverlap(Vec2 center, float radius, const Rect& rec) {
+    float dx = center.x - clampf(center.x, rec.x, rec.x + rec.width);
+    float dy = center.y - clampf(center.y, rec.y, rec.y + rec.height);
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+// Earliest t in [0, 1] at which start + delta * t is inside the rectangle (slab test)
+inline bool segmentRectTime(Vec2 start, Vec2 delta, const Rect& rec, float& t) {
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    const float origin[2] = {start.x, start.y};
+    const float dir[2] = {delta.x, delta.y};
+    const float lo[2] = {rec.x, rec.y};
+    const float hi[2] = {rec.x + rec.width, rec.y + rec.height};
+    for (int axis = 0; axis < 2; axis++) {
+        if (dir[axis] == 0.0f) {
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t0 = (lo[axis] - origin[axis]) / dir[axis];
+        float t1 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t0 > t1) {
+            float swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        tEnter = t0 > tEnter ? t0 : tEnter;
+        tExit = t1 < tExit ? t1 : tExit;
+        if (tEnter > tExit) {
+            return false;
+        }
+    }
+    t = tEnter;
+    return true;
+}
+
+// Earliest t in [0, 1] at which start + delta * t is inside the circle
+inline bool segmentCircleTime(Vec2 start, Vec2 delta, Vec2 center, float radius, float& t) {
+    float mx = start.x - center.x;
+    float my = start.y - center.y;
+    float c = mx * mx + my * my - radius * radius;
+    if (c <= 0.0f) {
+        t = 0.0f;
+        return true;
+    }
+    float a = delta.x * delta.x + delta.y * delta.y;
+    float b = mx * delta.x + my * delta.y;
+    float disc = b * b - a * c;
+    if (a == 0.0f || b >= 0.0f || disc < 0.0f) {
+        return false;  // Not moving, moving away, or passing wide
+    }
+    t = (-b - sqrtf(disc)) / a;
+    return t <= 1.0f;
+}
+
+// Swept circle vs axis-aligned rectangle: the time of impact in [0, 1] of a
+// circle moving by delta over the step, so a fast circle cannot pass through
+// between two discrete tests. The rectangle grown by the radius is two crossed
+// rectangles plus a circle at each corner; the earliest hit on any of them wins.
+inline bool sweptCircleRect(Vec2 start, Vec2 delta, float radius, const Rect& rec, float& toi) {
+    // Most candidates pass nowhere near; their swept box misses the rectangle
+    float endX = start.x + delta.x;
+    float endY = start.y + delta.y;
+    if ((start.x < endX ? start.x : endX) - radius > rec.x + rec.width ||
+        (start.x > endX ? start.x : endX) + radius < rec.x ||
+        (start.y < endY ? start.y : endY) - radius > rec.y + rec.height ||
+        (start.y > endY ? start.y : endY) + radius < rec.y) {
+        return false;
+    }
+    if (circleRectOverlap(start, radius, rec)) {
+        toi = 0.0f;
+        return true;
+    }
+    bool hit = false;
+    float best = 1.0f;
+    float t;
+    Rect wide = {rec.x - radius, rec.y, rec.width + 2 * radius, rec.height};
+    Rect tall = {rec.x, rec.y - radius, rec.width, rec.height + 2 * radius};
+    for (const Rect& slab : {wide, tall}) {
+        if (segmentRectTime(start, delta, slab, t) && t <= best) {
+            best = t;
+            hit = true;
+        }
+    }
+    const Vec2 corners[4] = {
+        {rec.x, rec.y}, {rec.x + rec.width, rec.y},
+        {rec.x, rec.y + rec.height}, {rec.x + rec.width, rec.y + rec.height},
+    };
+    for (Vec2 corner : corners) {
+        if (segmentCircleTime(start, delta, corner, radius, t) && t <= best) {
+            best = t;
+            hit = true;
+        }
+    }
+    toi = best;
+    return hit;
+}
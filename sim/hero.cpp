@@ -0,0 +1,149 @@
+#include "hero.h"
+#include "config.h"
+
+Hero::Hero(int p, float cX, float cY, float frameWidth, float frameHeight)
+: points(p), centerX(cX), centerY(cY),
+  xvelocity(0), yvelocity(0), isMoving(false),
+  isFacingRight(true),
+  currentFrame(0), frameTimer(0), framesSpeed(10) {
+    heroRect = {
+        cX - frameWidth / 2.0f,
+        cY - frameHeight / 2.0f,
+        frameWidth,
+        frameHeight
+    };
+    prevRect = heroRect;
+}
+
+void Hero::resetPos(float cX, float cY) {
+    centerX = cX;
+    centerY = cY;
+    heroRect.x = cX - heroRect.width / 2;
+    heroRect.y = cY - heroRect.height / 2;
+    prevRect = heroRect;
+}
+
+HeroIntent ReadHeroIntent(const InputState& input) {
+    return {input.up, input.down, input.left, input.right};
+}
+
+void Hero::move(const HeroIntent& intent, float dt, int screenWidth, int screenHeight) {
+    isMoving = false;
+    prevRect = heroRect;
+    float dx = xvelocity * dt;
+    float dy = yvelocity * dt;
+
+    if (intent.up && heroRect.y > 0) {
+        centerY -= dy;
+        heroRect.y -= dy;
+        isMoving = true;
+    }
+    if (intent.down && heroRect.y + heroRect.height < screenHeight) {
+        centerY += dy;
+        heroRect.y += dy;
+        isMoving = true;
+    }
+    if (intent.left && heroRect.x > 0) {
+        centerX -= dx;
+        heroRect.x -= dx;
+        isMoving = true;
+        isFacingRight = false;
+    }
+    if (intent.right && heroRect.x + heroRect.width < screenWidth) {
+        centerX += dx;
+        heroRect.x += dx;
+        isMoving = true;
+        isFacingRight = true;
+    }
+}
+
+void Hero::animate(float dt) {
+    if (!isMoving) {
+        currentFrame = 0;  // Reset to first frame when not moving
+        frameTimer = 0;
+        return;
+    }
+
+    frameTimer += dt;
+    if (frameTimer >= 1.0f / framesSpeed) {
+        frameTimer = 0;
+
+        // Modify animation logic for reversed running when facing left
+        if (isFacingRight) {
+            currentFrame++;
+            if (currentFrame >= HERO_FRAMES) {
+                currentFrame = 0;
+            }
+        } else {
+            currentFrame--;
+            if (currentFrame < 0) {  // Reverse animation when facing left
+                currentFrame = HERO_FRAMES - 1;
+            }
+        }
+    }
+}
+
+bool Hero::checkCollision(const BallSystem& balls, const SpatialGrid& grid, float maxTravel) const {
+    // Only balls near where the hero was or is, give or take a step of travel, can touch it
+    float left = fminf(prevRect.x, heroRect.x) - maxTravel;
+    float top = fminf(prevRect.y, heroRect.y) - maxTravel;
+    float right = fmaxf(prevRect.x + prevRect.width, heroRect.x + heroRect.width) + maxTravel;
+    float bottom = fmaxf(prevRect.y + prevRect.height, heroRect.y + heroRect.height) + maxTravel;
+    Rect area = {left, top, right - left, bottom - top};
+
+    // In the hero's frame the ball moves by its own step less the hero's, against
+    // the rectangle where the hero started the step
+    float heroDx = heroRect.x - prevRect.x;
+    float heroDy = heroRect.y - prevRect.y;
+    return grid.forEachNear(area, [&](int i) {
+        Vec2 end = {balls.posX(i), balls.posY(i)};
+        if (circleRectOverlap(end, balls.radius[i], heroRect)) {
+            return true;
+        }
+        // Touching from the start means the ball spawned on the hero this step; as
+        // with the discrete test, that only counts if it is still touching at the end
+        Vec2 start = {balls.prevPosX(i), balls.prevPosY(i)};
+        Vec2 delta = {end.x - start.x - heroDx, end.y - start.y - heroDy};
+        float toi;
+        return sweptCircleRect(start, delta, balls.radius[i], prevRect, toi) && toi > 0.0f;
+    });
+}
+
+void Hero::save(ByteWriter& out) const {
+    out.put<int32_t>(points);
+    out.put(centerX);
+    out.put(centerY);
+    out.put(xvelocity);
+    out.put(yvelocity);
+    for (const Rect& r : {heroRect, prevRect}) {
+        out.put(r.x);
+        out.put(r.y);
+        out.put(r.width);
+        out.put(r.height);
+    }
+    out.put<uint8_t>(isMoving);
+    out.put<uint8_t>(isFacingRight);
+    out.put<int32_t>(currentFrame);
+    out.put(frameTimer);
+    out.put<int32_t>(framesSpeed);
+}
+
+bool Hero::load(ByteReader& in) {
+    points = in.get<int32_t>();
+    centerX = in.get<float>();
+    centerY = in.get<float>();
+    xvelocity = in.get<float>();
+    yvelocity = in.get<float>();
+    for (Rect* r : {&heroRect, &prevRect}) {
+        r->x = in.get<float>();
+        r->y = in.get<float>();
+        r->width = in.get<float>();
+        r->height = in.get<float>();
+    }
+    isMoving = in.get<uint8_t>() != 0;
+    isFacingRight = in.get<uint8_t>() != 0;
+    currentFrame = in.get<int32_t>();
+    frameTimer = in.get<float>();
+    framesSpeed = in.get<int32_t>();
+    return in.ok();
+}
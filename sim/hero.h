@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ball_system.h"
+#include "byte_io.h"
+#include "geometry.h"
+#include "input.h"
+#include "spatial_grid.h"
+
+// The directions the player asked to move in this step
+struct HeroIntent {
+    bool up, down, left, right;
+};
+
+HeroIntent ReadHeroIntent(const InputState& input);
+
+// Hero movement, animation state and collision. Drawing the sprite is the
+// renderer's job; the hero only tracks which frame is current. A step runs
+// ReadHeroIntent, then move, then animate.
+class Hero {
+public:
+    int points;
+    float centerX, centerY, xvelocity, yvelocity;
+    Rect heroRect;
+    Rect prevRect;         // heroRect at the previous simulation step, for interpolation
+    bool isMoving;
+    bool isFacingRight;
+    int currentFrame;
+    float frameTimer;
+    int framesSpeed;       // Animation frames per second
+
+    Hero(int p, float cX, float cY, float frameWidth, float frameHeight);
+
+    void resetPos(float cX, float cY);
+    // Moves toward the intent without leaving the screen, and sets isMoving and facing
+    void move(const HeroIntent& intent, float dt, int screenWidth, int screenHeight);
+    // Runs the walk cycle while moving, and rests on the first frame otherwise
+    void animate(float dt);
+    // Sweeps each ball from its previous position against the hero's own motion
+    // over the step. maxTravel bounds how far a ball moved on either axis.
+    bool checkCollision(const BallSystem& balls, const SpatialGrid& grid, float maxTravel) const;
+
+    void save(ByteWriter& out) const;
+    bool load(ByteReader& in);
+};
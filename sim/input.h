@@ -0,0 +1,17 @@
+#pragma once
+
+#include "geometry.h"
+
+// Everything the simulation reads from the player for one step. The game fills
+// it from raylib, the headless driver from a script, a replay from its log.
+// Anything that changes the simulation must come through here, or replays drift.
+struct InputState {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+    bool mousePressed = false;     // Left button went down since the last step
+    bool restart = false;          // Retry after game over
+    bool toggleCollisions = false; // Flip ball-ball collisions
+    Vec2 mouse = {0.0f, 0.0f};
+};
@@ -0,0 +1,131 @@
+#include "job_system.h"
+
+// Which pool and queue the current thread belongs to; workers set these on start
+static thread_local const JobSystem* tlsSystem = nullptr;
+static thread_local int tlsQueue = 0;
+
+JobSystem::JobSystem(int threadCount)
+: stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int JobSystem::currentQueue() const {
+    return tlsSystem == this ? tlsQueue : 0;
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter& counter) {
+    counter.pending.fetch_add(1);
+    Queue& queue = *queues[currentQueue()];
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.jobs.push_back({std::move(job), &counter});
+    }
+    queued.fetch_add(1);
+    {
+        // Taking the lock orders this with a worker checking queued before sleeping
+        std::lock_guard<std::mutex> guard(sleepLock);
+    }
+    wake.notify_one();
+}
+
+bool JobSystem::pop(int self, Job& job) {
+    Queue& queue = *queues[self];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(int self, Job& job) {
+    int count = static_cast<int>(queues.size());
+    for (int k = 1; k < count; k++) {
+        Queue& victim = *queues[(self + k) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::runOne(int self) {
+    Job job;
+    if (!pop(self, job) && !steal(self, job)) {
+        return false;
+    }
+    queued.fetch_sub(1);
+    job.fn();
+    job.counter->pending.fetch_sub(1);
+    return true;
+}
+
+void JobSystem::workerLoop(int self) {
+    tlsSystem = this;
+    tlsQueue = self;
+    while (true) {
+        if (runOne(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepLock);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    int self = currentQueue();
+    while (counter.pending.load() > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (grain < 1) {
+        grain = 1;
+    }
+    if (workers.empty() || count <= grain) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+    JobCounter counter;
+    // Keep the first chunk for this thread; the rest are up for stealing
+    for (int begin = grain; begin < count; begin += grain) {
+        int end = begin + grain < count ? begin + grain : count;
+        submit([&fn, begin, end] { fn(begin, end); }, counter);
+    }
+    fn(0, grain);
+    wait(counter);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts outstanding jobs; wait() on it to join them. Several jobs can share a
+// counter, and a job may submit more work against another one, which is enough
+// to express the frame's passes as a dependency graph.
+struct JobCounter {
+    std::atomic<int> pending{0};
+};
+
+// Small work-stealing thread pool. Every worker owns a deque: it pushes and pops
+// its own jobs at the back and steals from the front of the others when idle.
+// Threads that wait on a counter keep running jobs instead of blocking.
+class JobSystem {
+public:
+    // threadCount includes the calling thread; 0 uses every hardware thread
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    void submit(std::function<void()> job, JobCounter& counter);
+    void wait(JobCounter& counter);
+
+    // Runs fn(begin, end) over [0, count) in chunks of at most grain items and
+    // returns when all are done. Small ranges run inline on the caller.
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        JobCounter* counter;
+    };
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // [0] is shared by non-worker threads
+    std::vector<std::thread> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<int> queued{0};
+    bool stopping;
+
+    int currentQueue() const;
+    bool runOne(int self);
+    bool pop(int self, Job& job);
+    bool steal(int self, Job& job);
+    void workerLoop(int self);
+};
+
+// parallelFor that also accepts no job system, for single-threaded callers
+inline void ParallelFor(JobSystem* jobs, int count, int grain, const std::function<void(int, int)>& fn) {
+    if (jobs) {
+        jobs->parallelFor(count, grain, fn);
+    } else if (count > 0) {
+        fn(0, count);
+    }
+}
@@ -0,0 +1,79 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+FrameProfiler::FrameProfiler() {
+    std::fill(current, current + PROFILE_PHASE_COUNT, 0.0f);
+}
+
+void FrameProfiler::beginFrame() {
+    std::fill(current, current + PROFILE_PHASE_COUNT, 0.0f);
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::endFrame() {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - frameStart;
+    current[PROFILE_FRAME] = static_cast<float>(elapsed.count());
+    history.insert(history.end(), current, current + PROFILE_PHASE_COUNT);
+}
+
+ProfileStats FrameProfiler::stats(ProfilePhase phase) const {
+    int frames = frameCount();
+    int first = frames > WINDOW ? frames - WINDOW : 0;
+    int n = frames - first;
+    if (n == 0) {
+        return {0.0, 0.0, 0.0};
+    }
+
+    float window[WINDOW];
+    double sum = 0.0;
+    for (int f = first; f < frames; f++) {
+        float ms = history[f * PROFILE_PHASE_COUNT + phase];
+        window[f - first] = ms;
+        sum += ms;
+    }
+    int p99 = (n * 99) / 100;
+    if (p99 >= n) {
+        p99 = n - 1;
+    }
+    std::nth_element(window, window + p99, window + n);
+    float p99Ms = window[p99];
+    return {*std::min_element(window, window + n), sum / n, p99Ms};
+}
+
+bool FrameProfiler::writeCsv(const char* fileName) const {
+    FILE* file = fopen(fileName, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "frame");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        fprintf(file, ",%s_ms", phaseName(static_cast<ProfilePhase>(p)));
+    }
+    fprintf(file, "\n");
+    int frames = frameCount();
+    for (int f = 0; f < frames; f++) {
+        fprintf(file, "%d", f);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            fprintf(file, ",%.4f", history[f * PROFILE_PHASE_COUNT + p]);
+        }
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0;
+}
+
+const char* FrameProfiler::phaseName(ProfilePhase phase) {
+    switch (phase) {
+        case PROFILE_WAIT: return "wait";
+        case PROFILE_INPUT: return "input";
+        case PROFILE_HERO: return "hero";
+        case PROFILE_BALLS: return "balls";
+        case PROFILE_COLLISION: return "collision";
+        case PROFILE_PHASE: return "phase";
+        case PROFILE_CLICK: return "click";
+        case PROFILE_DRAW: return "draw";
+        case PROFILE_PRESENT: return "present";
+        case PROFILE_FRAME: return "frame";
+        default: return "?";
+    }
+}
@@ -0,0 +1,315 @@
+#include "replay.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char REPLAY_MAGIC[8] = {'N', 'T', 'T', 'D', 'R', 'P', 'L', '1'};
+static const char INDEX_MAGIC[8] = {'N', 'T', 'T', 'D', 'I', 'D', 'X', '1'};
+static const size_t TRAILER_BYTES = 8 + 4 + 8 + sizeof(INDEX_MAGIC);
+
+enum InputBits : uint8_t {
+    INPUT_UP = 1,
+    INPUT_DOWN = 2,
+    INPUT_LEFT = 4,
+    INPUT_RIGHT = 8,
+    INPUT_MOUSE = 16,
+    INPUT_RESTART = 32,
+    INPUT_TOGGLE_COLLISIONS = 64,
+};
+
+ReplayHeader ReplayHeader::forWorld(const World& world, uint64_t seed) {
+    ReplayHeader header;
+    header.simHz = SIM_HZ;
+    header.width = static_cast<uint16_t>(world.width);
+    header.height = static_cast<uint16_t>(world.height);
+    header.seed = seed;
+    header.startBalls = static_cast<uint32_t>(world.startBalls);
+    header.options = (world.invincible ? REPLAY_INVINCIBLE : 0) |
+                     (world.ballCollisions ? REPLAY_BALL_COLLISIONS : 0) |
+                     (world.balls.isQuantized() ? REPLAY_QUANTIZED : 0);
+    return header;
+}
+
+void ReplayHeader::apply(World& world) const {
+    world.invincible = (options & REPLAY_INVINCIBLE) != 0;
+    world.ballCollisions = (options & REPLAY_BALL_COLLISIONS) != 0;
+    world.balls.setQuantized((options & REPLAY_QUANTIZED) != 0);
+    world.startBalls = static_cast<int>(startBalls);
+    world.spawnBalls(world.startBalls);
+}
+
+uint8_t PackInputBits(const InputState& input) {
+    return (input.up ? INPUT_UP : 0) |
+           (input.down ? INPUT_DOWN : 0) |
+           (input.left ? INPUT_LEFT : 0) |
+           (input.right ? INPUT_RIGHT : 0) |
+           (input.mousePressed ? INPUT_MOUSE : 0) |
+           (input.restart ? INPUT_RESTART : 0) |
+           (input.toggleCollisions ? INPUT_TOGGLE_COLLISIONS : 0);
+}
+
+void UnpackInputBits(uint8_t bits, InputState& input) {
+    input.up = (bits & INPUT_UP) != 0;
+    input.down = (bits & INPUT_DOWN) != 0;
+    input.left = (bits & INPUT_LEFT) != 0;
+    input.right = (bits & INPUT_RIGHT) != 0;
+    input.mousePressed = (bits & INPUT_MOUSE) != 0;
+    input.restart = (bits & INPUT_RESTART) != 0;
+    input.toggleCollisions = (bits & INPUT_TOGGLE_COLLISIONS) != 0;
+}
+
+ReplayRecorder::ReplayRecorder()
+: file(nullptr), keyframeSteps(KEYFRAME_STEPS), step(0), offset(0), failed(false),
+  blockSteps(0), runBits(0), runLength(0) {}
+
+ReplayRecorder::~ReplayRecorder() {
+    close();
+}
+
+bool ReplayRecorder::open(const char* fileName, const ReplayHeader& header, int keyframeInterval) {
+    close();
+    file = fopen(fileName, "wb");
+    if (!file) {
+        return false;
+    }
+    keyframeSteps = std::max(keyframeInterval, 1);
+    step = 0;
+    offset = 0;
+    failed = false;
+    index.clear();
+
+    std::vector<unsigned char> bytes;
+    ByteWriter out(bytes);
+    out.putBytes(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    out.put(header.simHz);
+    out.put(header.width);
+    out.put(header.height);
+    out.put(header.seed);
+    out.put(header.startBalls);
+    out.put(header.options);
+    write(bytes);
+    return !failed;
+}
+
+void ReplayRecorder::write(const std::vector<unsigned char>& bytes) {
+    if (fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+        failed = true;
+    }
+    offset += bytes.size();
+}
+
+void ReplayRecorder::record(const World& world, const InputState& input) {
+    if (!file) {
+        return;
+    }
+    if (step % keyframeSteps == 0) {
+        flushBlock();
+        index.push_back({step, offset});
+        state.clear();
+        ByteWriter out(state);
+        world.saveState(out);
+    }
+
+    uint8_t bits = PackInputBits(input);
+    ByteWriter out(runs);
+    if (input.mousePressed) {
+        // Clicks carry their position, so they never join a run
+        flushRun();
+        out.put(bits);
+        out.put(input.mouse.x);
+        out.put(input.mouse.y);
+    } else if (runLength > 0 && bits == runBits) {
+        runLength++;
+    } else {
+        flushRun();
+        runBits = bits;
+        runLength = 1;
+    }
+    blockSteps++;
+    step++;
+}
+
+void ReplayRecorder::flushRun() {
+    if (runLength == 0) {
+        return;
+    }
+    ByteWriter out(runs);
+    out.put(runBits);
+    out.putVarint(runLength);
+    runLength = 0;
+}
+
+void ReplayRecorder::flushBlock() {
+    if (blockSteps == 0) {
+        return;
+    }
+    flushRun();
+    std::vector<unsigned char> bytes;
+    ByteWriter out(bytes);
+    out.put(static_cast<uint32_t>(state.size()));
+    out.putBytes(state.data(), state.size());
+    out.put(blockSteps);
+    out.put(static_cast<uint32_t>(runs.size()));
+    out.putBytes(runs.data(), runs.size());
+    write(bytes);
+    runs.clear();
+    blockSteps = 0;
+}
+
+bool ReplayRecorder::close() {
+    if (!file) {
+        return true;
+    }
+    flushBlock();
+    std::vector<unsigned char> bytes;
+    ByteWriter out(bytes);
+    uint64_t indexOffset = offset;
+    for (const ReplayIndexEntry& entry : index) {
+        out.put(entry.step);
+        out.put(entry.offset);
+    }
+    out.put(step);
+    out.put(static_cast<uint32_t>(index.size()));
+    out.put(indexOffset);
+    out.putBytes(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    write(bytes);
+
+    bool ok = fclose(file) == 0 && !failed;
+    file = nullptr;
+    return ok;
+}
+
+ReplayPlayer::ReplayPlayer()
+: header(), totalSteps(0), cursor(0), block(-1), runPos(nullptr), runEnd(nullptr),
+  blockStepsLeft(0), runLeft(0) {}
+
+bool ReplayPlayer::open(const char* fileName) {
+    if (!file.open(fileName)) {
+        return false;
+    }
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    if (size < sizeof(REPLAY_MAGIC) + TRAILER_BYTES || memcmp(data, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return false;
+    }
+
+    ByteReader in(data + sizeof(REPLAY_MAGIC), size - sizeof(REPLAY_MAGIC));
+    header.simHz = in.get<uint16_t>();
+    header.width = in.get<uint16_t>();
+    header.height = in.get<uint16_t>();
+    header.seed = in.get<uint64_t>();
+    header.startBalls = in.get<uint32_t>();
+    header.options = in.get<uint8_t>();
+    // A log from a different tick rate would replay at the wrong speed
+    if (!in.ok() || header.simHz != SIM_HZ) {
+        return false;
+    }
+
+    const unsigned char* trailer = data + size - TRAILER_BYTES;
+    if (memcmp(trailer + TRAILER_BYTES - sizeof(INDEX_MAGIC), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return false;  // Unfinished recording
+    }
+    ByteReader tail(trailer, TRAILER_BYTES);
+    totalSteps = static_cast<int64_t>(tail.get<uint64_t>());
+    uint32_t blocks = tail.get<uint32_t>();
+    uint64_t indexOffset = tail.get<uint64_t>();
+    if (indexOffset > size - TRAILER_BYTES || (size - TRAILER_BYTES - indexOffset) / 16 < blocks) {
+        return false;
+    }
+    ByteReader entries(data + indexOffset, blocks * 16);
+    index.resize(blocks);
+    for (ReplayIndexEntry& entry : index) {
+        entry.step = entries.get<uint64_t>();
+        entry.offset = entries.get<uint64_t>();
+        if (entry.offset >= indexOffset) {
+            return false;
+        }
+    }
+    cursor = 0;
+    block = -1;
+    blockStepsLeft = 0;
+    runLeft = 0;
+    return entries.ok();
+}
+
+// Moves decoding to the start of block b, loading its keyframe into world if given
+bool ReplayPlayer::enterBlock(int b, World* world) {
+    if (b < 0 || b >= static_cast<int>(index.size())) {
+        return false;
+    }
+    const unsigned char* start = file.data() + index[b].offset;
+    ByteReader in(start, file.size() - TRAILER_BYTES - index[b].offset);
+    uint32_t stateBytes = in.get<uint32_t>();
+    if (!in.ok() || stateBytes > in.remaining()) {
+        return false;
+    }
+    if (world) {
+        ByteReader state(in.position(), stateBytes);
+        if (!world->loadState(state)) {
+            return false;
+        }
+    }
+    in.skip(stateBytes);
+    blockStepsLeft = in.get<uint32_t>();
+    uint32_t runBytes = in.get<uint32_t>();
+    if (!in.ok() || runBytes > in.remaining()) {
+        return false;
+    }
+    block = b;
+    runPos = in.position();
+    runEnd = runPos + runBytes;
+    runLeft = 0;
+    cursor = static_cast<int64_t>(index[b].step);
+    return true;
+}
+
+bool ReplayPlayer::seek(World& world, double ms) {
+    if (index.empty()) {
+        return false;
+    }
+    int64_t target = static_cast<int64_t>(llround(ms * header.simHz / 1000.0));
+    target = std::min(std::max(target, static_cast<int64_t>(0)), totalSteps);
+    auto after = std::upper_bound(index.begin(), index.end(), static_cast<uint64_t>(target),
+                                  [](uint64_t step, const ReplayIndexEntry& entry) { return step < entry.step; });
+    int b = static_cast<int>(after - index.begin()) - 1;
+    if (!enterBlock(b, &world)) {
+        return false;
+    }
+    InputState input;
+    while (cursor < target && next(input)) {
+        world.step(input);
+    }
+    return cursor == target;
+}
+
+bool ReplayPlayer::next(InputState& input) {
+    if (cursor >= totalSteps) {
+        return false;
+    }
+    if (blockStepsLeft == 0 && !enterBlock(block + 1, nullptr)) {
+        return false;
+    }
+    if (runLeft == 0) {
+        ByteReader in(runPos, static_cast<size_t>(runEnd - runPos));
+        uint8_t bits = in.get<uint8_t>();
+        run = InputState();
+        UnpackInputBits(bits, run);
+        if (run.mousePressed) {
+            run.mouse.x = in.get<float>();
+            run.mouse.y = in.get<float>();
+            runLeft = 1;
+        } else {
+            runLeft = in.getVarint();
+        }
+        if (!in.ok() || runLeft == 0) {
+            return false;
+        }
+        runPos = in.position();
+    }
+    input = run;
+    runLeft--;
+    blockStepsLeft--;
+    cursor++;
+    return true;
+}
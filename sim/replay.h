@@ -0,0 +1,112 @@
+#pragma once
+
+#include "byte_io.h"
+#include "input.h"
+#include "mapped_file.h"
+#include "world.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Replay file format (little endian):
+//   "NTTDRPL1", u16 simHz, u16 width, u16 height, u64 seed, u32 startBalls, u8 options
+//   blocks, one every keyframe interval:
+//     u32 state bytes, World::saveState() taken before the block's first step
+//     u32 steps, u32 run bytes, input runs
+//   index: per block u64 first step, u64 file offset
+//   trailer: u64 total steps, u32 blocks, u64 index offset, "NTTDIDX1"
+//
+// Inputs are stored as runs: a u8 input bits plus a varint repeat count, or for a
+// click the bits plus f32 mouse x, y. Held keys change rarely, so a minute of play
+// is usually a few dozen bytes. Seeking restores the nearest keyframe at or before
+// the target and re-simulates at most one interval.
+
+enum ReplayOptions : uint8_t {
+    REPLAY_INVINCIBLE = 1,
+    REPLAY_BALL_COLLISIONS = 2,
+    REPLAY_QUANTIZED = 4,
+};
+
+struct ReplayHeader {
+    uint16_t simHz;
+    uint16_t width, height;
+    uint64_t seed;
+    uint32_t startBalls;
+    uint8_t options;
+
+    static ReplayHeader forWorld(const World& world, uint64_t seed);
+    // Applies the options to a world freshly built from width, height and seed
+    void apply(World& world) const;
+};
+
+// Packs an input into the one-byte step record; the mouse rides along on clicks
+uint8_t PackInputBits(const InputState& input);
+void UnpackInputBits(uint8_t bits, InputState& input);
+
+struct ReplayIndexEntry {
+    uint64_t step;    // First step of the block
+    uint64_t offset;  // File offset of its keyframe
+};
+
+class ReplayRecorder {
+public:
+    static const int KEYFRAME_STEPS = 600;  // 10 s at SIM_HZ
+
+    ReplayRecorder();
+    ~ReplayRecorder();
+
+    bool open(const char* fileName, const ReplayHeader& header, int keyframeSteps = KEYFRAME_STEPS);
+    // Call with the world as it is before stepping it with this input
+    void record(const World& world, const InputState& input);
+    bool close();  // Writes the last block and the index
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    FILE* file;
+    int keyframeSteps;
+    uint64_t step;
+    uint64_t offset;
+    bool failed;
+    std::vector<unsigned char> state;  // Keyframe of the open block
+    std::vector<unsigned char> runs;   // Encoded inputs of the open block
+    uint32_t blockSteps;
+    uint8_t runBits;
+    uint64_t runLength;
+    std::vector<ReplayIndexEntry> index;
+
+    void write(const std::vector<unsigned char>& bytes);
+    void flushRun();
+    void flushBlock();
+};
+
+// Reads a replay through a memory map, so only the blocks that are visited get paged in
+class ReplayPlayer {
+public:
+    ReplayPlayer();
+
+    bool open(const char* fileName);
+    const ReplayHeader& getHeader() const { return header; }
+    int64_t stepCount() const { return totalSteps; }
+    int64_t position() const { return cursor; }
+    double durationMs() const { return totalSteps * 1000.0 / header.simHz; }
+    double positionMs() const { return cursor * 1000.0 / header.simHz; }
+
+    // Puts the world at the step nearest ms, clamped to the recording
+    bool seek(World& world, double ms);
+    bool next(InputState& input);  // False once the log is exhausted
+
+private:
+    MappedFile file;
+    ReplayHeader header;
+    std::vector<ReplayIndexEntry> index;
+    int64_t totalSteps;
+    int64_t cursor;
+    int block;                      // Block the cursor is in, -1 before the first
+    const unsigned char* runPos;    // Next undecoded run of that block
+    const unsigned char* runEnd;
+    uint32_t blockStepsLeft;
+    InputState run;
+    uint64_t runLeft;
+
+    bool enterBlock(int b, World* world);
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-world PCG32 generator. Unlike rand() it is seedable per instance and gives
+// the same sequence on every platform, which replays depend on.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 1) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + INCREMENT;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform-ish in [0, n), the same way rand() % n was used before
+    int range(int n) { return static_cast<int>(next() % static_cast<uint32_t>(n)); }
+
+    uint64_t getState() const { return state; }
+    void setState(uint64_t s) { state = s; }
+
+private:
+    static const uint64_t INCREMENT = 1442695040888963407ULL;
+    uint64_t state;
+};
@@ -0,0 +1,71 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(int width, int height, int size)
+: cellSize(size),
+  cellsX((width + size - 1) / size),
+  cellsY((height + size - 1) / size),
+  maxRadius(0), built(false), linearCount(-1),
+  cellStart(cellsX * cellsY + 1, 0) {}
+
+static int clampCell(int c, int cells) {
+    return c < 0 ? 0 : (c >= cells ? cells - 1 : c);
+}
+
+int SpatialGrid::cellIndex(float px, float py) const {
+    int cx = clampCell(static_cast<int>(px) / cellSize, cellsX);
+    int cy = clampCell(static_cast<int>(py) / cellSize, cellsY);
+    return cy * cellsX + cx;
+}
+
+void SpatialGrid::cellRange(const Rect& area, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = clampCell(static_cast<int>(area.x - maxRadius) / cellSize, cellsX);
+    y0 = clampCell(static_cast<int>(area.y - maxRadius) / cellSize, cellsY);
+    x1 = clampCell(static_cast<int>(area.x + area.width + maxRadius) / cellSize, cellsX);
+    y1 = clampCell(static_cast<int>(area.y + area.height + maxRadius) / cellSize, cellsY);
+}
+
+void SpatialGrid::rebuild(const BallSystem& balls, JobSystem* jobs) {
+    int count = balls.size();
+    if (count <= LINEAR_MAX_BALLS) {
+        linearCount = count;
+        built = true;
+        return;
+    }
+    linearCount = -1;
+    ballCell.resize(count);
+    cellItems.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+
+    // Binning is independent per ball and runs in parallel; the counting sort
+    // (count per cell, prefix sum, then scatter) stays on this thread.
+    chunkMaxRadius.assign((count + REBUILD_GRAIN - 1) / REBUILD_GRAIN, 0.0f);
+    ParallelFor(jobs, count, REBUILD_GRAIN, [&](int begin, int end) {
+        float chunkMax = 0;
+        for (int i = begin; i < end; i++) {
+            ballCell[i] = cellIndex(balls.posX(i), balls.posY(i));
+            chunkMax = balls.radius[i] > chunkMax ? balls.radius[i] : chunkMax;
+        }
+        chunkMaxRadius[begin / REBUILD_GRAIN] = chunkMax;
+    });
+
+    maxRadius = 0;
+    for (float r : chunkMaxRadius) {
+        maxRadius = r > maxRadius ? r : maxRadius;
+    }
+    for (int i = 0; i < count; i++) {
+        cellStart[ballCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    for (int i = 0; i < count; i++) {
+        cellItems[cellStart[ballCell[i]]++] = i;
+    }
+    // The scatter advanced each start to the next cell's start; shift back
+    for (size_t c = cellStart.size() - 1; c > 0; c--) {
+        cellStart[c] = cellStart[c - 1];
+    }
+    cellStart[0] = 0;
+    built = true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ball_system.h"
+#include "geometry.h"
+#include "job_system.h"
+#include <vector>
+
+// Uniform grid over the playfield, bucketing balls by the cell holding their
+// center. Rebuilt with a counting sort after each integration step, so hero and
+// mouse queries only visit the handful of cells around them.
+//
+// With only a few balls, sweeping every cell costs more than testing every ball,
+// so the grid is skipped and queries visit all of them.
+class SpatialGrid {
+public:
+    static const int DEFAULT_CELL_SIZE = 64;
+    static const int REBUILD_GRAIN = 8192;  // Balls per job when binning
+    static const int LINEAR_MAX_BALLS = 64;  // Up to this many, queries scan every ball
+
+    SpatialGrid(int width, int height, int cellSize = DEFAULT_CELL_SIZE);
+
+    void rebuild(const BallSystem& balls, JobSystem* jobs = nullptr);
+    bool isBuilt() const { return built; }
+    void invalidate() { built = false; }
+
+    // Calls fn(index) for every ball whose cell is near the area; stops early and
+    // returns true as soon as fn returns true. Candidates still need an exact test.
+    template <class Fn>
+    bool forEachNear(const Rect& area, Fn fn) const {
+        if (linearCount >= 0) {
+            for (int i = 0; i < linearCount; i++) {
+                if (fn(i)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        int x0, y0, x1, y1;
+        cellRange(area, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int cell = cy * cellsX + cx;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                    if (fn(cellItems[k])) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    int cellSize;
+    int cellsX, cellsY;
+    float maxRadius;         // Largest radius at the last rebuild, pads every query
+    bool built;
+    int linearCount;         // Balls scanned in place of the cells, -1 when binned
+    std::vector<int> cellStart;  // cellsX * cellsY + 1 offsets into cellItems
+    std::vector<int> cellItems;  // Ball indices, grouped by cell
+    std::vector<int> ballCell;   // Scratch: cell of each ball during rebuild
+    std::vector<float> chunkMaxRadius;
+
+    int cellIndex(float px, float py) const;
+    void cellRange(const Rect& area, int& x0, int& y0, int& x1, int& y1) const;
+};
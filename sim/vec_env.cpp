@@ -0,0 +1,117 @@
+#include "vec_env.h"
+#include "config.h"
+
+VecEnv::VecEnv(const VecEnvConfig& envConfig, JobSystem* jobSystem)
+: config(envConfig), jobs(jobSystem), stepCount(0), episodeCount(0) {
+    int count = config.count;
+    worlds.reserve(count);
+    for (int i = 0; i < count; i++) {
+        worlds.emplace_back(new World(SCREEN_WIDTH, SCREEN_HEIGHT, config.seed + i, config.ballCapacity));
+        worlds.back()->startBalls = config.startBalls;
+        worlds.back()->ballCollisions = config.ballCollisions;
+    }
+    obs.assign(static_cast<size_t>(FEATURES) * count, 0.0f);
+    reward.assign(count, 0.0f);
+    done.assign(count, 0);
+    steps.assign(count, 0);
+    reset();
+}
+
+void VecEnv::reset() {
+    ParallelFor(jobs, size(), STEP_GRAIN, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            worlds[i]->reset();
+            reward[i] = 0.0f;
+            done[i] = 0;
+            steps[i] = 0;
+            observe(i);
+        }
+    });
+}
+
+void VecEnv::step(const uint8_t* actions, const Vec2* clicks) {
+    ParallelFor(jobs, size(), STEP_GRAIN, [&](int begin, int end) {
+        stepRange(begin, end, actions, clicks);
+    });
+    stepCount += size();
+    for (uint8_t d : done) {
+        episodeCount += d;
+    }
+}
+
+void VecEnv::stepRange(int begin, int end, const uint8_t* actions, const Vec2* clicks) {
+    for (int i = begin; i < end; i++) {
+        World& world = *worlds[i];
+        uint8_t action = actions[i];
+        InputState input;
+        input.up = (action & ACTION_UP) != 0;
+        input.down = (action & ACTION_DOWN) != 0;
+        input.left = (action & ACTION_LEFT) != 0;
+        input.right = (action & ACTION_RIGHT) != 0;
+        if ((action & ACTION_CLICK) && clicks) {
+            input.mousePressed = true;
+            input.mouse = clicks[i];
+        }
+
+        int before = world.score;
+        world.step(input);
+        reward[i] = static_cast<float>(world.score - before);
+
+        bool ended = world.isGameOver || ++steps[i] >= config.maxEpisodeSteps;
+        done[i] = ended;
+        if (ended) {
+            world.reset();
+            steps[i] = 0;
+        }
+        observe(i);
+    }
+}
+
+void VecEnv::observe(int i) {
+    const World& world = *worlds[i];
+    const BallSystem& balls = world.balls;
+    size_t n = worlds.size();
+    float* out = obs.data() + i;  // Feature f lands at out[f * n]
+
+    float heroX = world.hero.heroRect.x + world.hero.heroRect.width / 2;
+    float heroY = world.hero.heroRect.y + world.hero.heroRect.height / 2;
+    out[OBS_HERO_X * n] = heroX / world.width;
+    out[OBS_HERO_Y * n] = heroY / world.height;
+    out[OBS_YELLOW * n] = world.isYellow ? 1.0f : 0.0f;
+    out[OBS_BALLS * n] = balls.size() / BALL_OBS_SCALE;
+
+    // Keep the closest few by insertion; ball counts per game are small
+    int nearest[NEAREST_BALLS];
+    float nearestDist[NEAREST_BALLS];
+    int found = 0;
+    for (int b = 0; b < balls.size(); b++) {
+        float dx = balls.posX(b) - heroX;
+        float dy = balls.posY(b) - heroY;
+        float dist = dx * dx + dy * dy;
+        if (found == NEAREST_BALLS && dist >= nearestDist[found - 1]) {
+            continue;
+        }
+        int k = found < NEAREST_BALLS ? found++ : found - 1;
+        for (; k > 0 && nearestDist[k - 1] > dist; k--) {
+            nearest[k] = nearest[k - 1];
+            nearestDist[k] = nearestDist[k - 1];
+        }
+        nearest[k] = b;
+        nearestDist[k] = dist;
+    }
+
+    // Velocities are what the ball will actually move at, time scale included
+    float speedScale = world.timeScale() / BALL_MOVING_SPEED;
+    for (int k = 0; k < NEAREST_BALLS; k++) {
+        float* ball = out + (OBS_NEAREST + k * OBS_PER_BALL) * n;
+        if (k < found) {
+            int b = nearest[k];
+            ball[0] = (balls.posX(b) - heroX) / world.width;
+            ball[n] = (balls.posY(b) - heroY) / world.height;
+            ball[2 * n] = balls.vx[b] * speedScale;
+            ball[3 * n] = balls.vy[b] * speedScale;
+        } else {
+            ball[0] = ball[n] = ball[2 * n] = ball[3 * n] = 0.0f;
+        }
+    }
+}
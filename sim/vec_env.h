@@ -0,0 +1,89 @@
+#pragma once
+
+#include "geometry.h"
+#include "job_system.h"
+#include "world.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// One environment's action for a step: keys held, plus an optional click
+enum EnvAction : uint8_t {
+    ACTION_UP = 1,
+    ACTION_DOWN = 2,
+    ACTION_LEFT = 4,
+    ACTION_RIGHT = 8,
+    ACTION_CLICK = 16,  // At the environment's entry in the clicks array
+};
+
+// What each environment sees after a step, as feature indices. The nearest
+// balls are ordered closest first; missing ones read as zero.
+enum EnvFeature {
+    OBS_HERO_X,       // Hero center over the playfield width, 0..1
+    OBS_HERO_Y,
+    OBS_YELLOW,       // 1 while balls can be clicked
+    OBS_BALLS,        // Balls on the field over BALL_OBS_SCALE
+    OBS_NEAREST,      // Then dx, dy, vx, vy per nearest ball
+    OBS_PER_BALL = 4,
+};
+
+struct VecEnvConfig {
+    int count = 1024;
+    uint64_t seed = 1;             // Environment i starts from seed + i
+    int startBalls = 0;            // Extra balls every episode starts with
+    bool ballCollisions = false;
+    int maxEpisodeSteps = 60 * SIM_HZ;  // Truncates episodes nobody loses
+    int ballCapacity = 256;        // Per environment; the pool grows past it if needed
+};
+
+// Batched environments for tuning and bot training: N independent worlds with
+// their own seeds, stepped together with one action each. Each world is the
+// game's own World, so the rules are exactly the game's; what crosses the API
+// is laid out structure-of-arrays across environments (one array per feature,
+// reward and done flag) so a learner reads each as a contiguous batch.
+//
+// Environments are spread over the job system in chunks. Each world steps
+// single-threaded, so nothing inside a step contends with its neighbours.
+// An environment that finishes is reset straight away: its done flag is set
+// and its observation already shows the new episode.
+class VecEnv {
+public:
+    static const int NEAREST_BALLS = 8;
+    static const int FEATURES = OBS_NEAREST + NEAREST_BALLS * OBS_PER_BALL;
+    static const int STEP_GRAIN = 32;  // Environments per job
+    static constexpr float BALL_OBS_SCALE = 64.0f;
+
+    explicit VecEnv(const VecEnvConfig& config, JobSystem* jobs = nullptr);
+
+    int size() const { return static_cast<int>(worlds.size()); }
+
+    void reset();  // Starts a new episode everywhere
+    // actions holds one EnvAction mask per environment; clicks may be null when
+    // no action clicks
+    void step(const uint8_t* actions, const Vec2* clicks = nullptr);
+
+    // Feature-major: feature f of environment i is at [f * size() + i]
+    const float* observations() const { return obs.data(); }
+    const float* observation(int feature) const { return obs.data() + static_cast<size_t>(feature) * size(); }
+    const float* rewards() const { return reward.data(); }  // Score gained in the last step
+    const uint8_t* dones() const { return done.data(); }     // Episode ended in the last step
+    const int* episodeSteps() const { return steps.data(); }
+
+    long long totalSteps() const { return stepCount; }
+    long long episodes() const { return episodeCount; }
+    const World& world(int i) const { return *worlds[i]; }
+
+private:
+    VecEnvConfig config;
+    JobSystem* jobs;
+    std::vector<std::unique_ptr<World>> worlds;
+    std::vector<float> obs;
+    std::vector<float> reward;
+    std::vector<uint8_t> done;
+    std::vector<int> steps;
+    long long stepCount;
+    long long episodeCount;
+
+    void stepRange(int begin, int end, const uint8_t* actions, const Vec2* clicks);
+    void observe(int i);
+};
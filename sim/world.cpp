@@ -0,0 +1,229 @@
+#include "world.h"
+#include "config.h"
+
+World::World(int screenWidth, int screenHeight, uint64_t seed, int ballCapacity)
+: width(screenWidth), height(screenHeight),
+  hero(5, screenWidth / 2, screenHeight / 2, HERO_FRAME_WIDTH, HERO_FRAME_HEIGHT),
+  grid(screenWidth, screenHeight),
+  score(0), simTime(0.0), lastSpawnTime(0.0), stateTime(0.0),
+  isYellow(false), canDelete(false), isGameOver(false), invincible(false), ballCollisions(false),
+  startBalls(0), rng(seed), jobs(nullptr), profiler(nullptr) {
+    hero.xvelocity = HERO_SPEED;
+    hero.yvelocity = HERO_SPEED;
+    balls.reserve(ballCapacity);
+    spawnRoundBalls();
+}
+
+void World::spawnBall(BallKind ballKind) {
+    int r = BALL_RADIUS;
+    int offset = BALL_KINDS[ballKind].spawnOffset;
+    float px = r + rng.range(width - 2 * r - offset);  // Adjust for offset
+    float py = r + rng.range(height - 2 * r - offset);
+    // Every ball travels diagonally at the base speed; only the direction is random
+    float xspeed = rng.range(2) == 0 ? BALL_IDLE_SPEED : -BALL_IDLE_SPEED;
+    float yspeed = rng.range(2) == 0 ? BALL_IDLE_SPEED : -BALL_IDLE_SPEED;
+    balls.spawn(px, py, xspeed, yspeed, r, ballKind);
+    grid.invalidate();
+}
+
+// Kinds in table order, so the random stream matches a given table
+void World::spawnRoundBalls() {
+    for (int k = 0; k < BALL_KIND_COUNT; k++) {
+        for (int i = 0; i < BALL_KINDS[k].perRound; i++) {
+            spawnBall(static_cast<BallKind>(k));
+        }
+    }
+}
+
+void World::spawnBalls(int count) {
+    balls.reserve(balls.size() + count);
+    for (int i = 0; i < count; i++) {
+        spawnBall(BALL_REGULAR);
+    }
+}
+
+void World::reset() {
+    isGameOver = false;
+    score = 0;
+
+    // Clear existing balls and recreate the ones every round starts with
+    balls.clear();
+    grid.invalidate();
+    spawnRoundBalls();
+    spawnBalls(startBalls);
+
+    hero.resetPos(width / 2, height / 2);
+    stateTime = simTime;
+    isYellow = false;
+    canDelete = false;
+}
+
+void World::step(const InputState& input) {
+    if (input.restart && isGameOver) {
+        reset();
+    }
+    if (input.toggleCollisions) {
+        ballCollisions = !ballCollisions;
+    }
+    simTime += SIM_DT;
+
+    if (!isGameOver) {
+        {
+            ProfileScope scope(profiler, PROFILE_HERO);
+            hero.move(ReadHeroIntent(input), SIM_DT, width, height);
+            hero.animate(SIM_DT);
+            if (hero.isMoving) {
+                score += SCORE_PER_SECOND / SIM_HZ;
+            }
+        }
+
+        {
+            ProfileScope scope(profiler, PROFILE_BALLS);
+            if (simTime - lastSpawnTime >= SPAWN_INTERVAL && !isYellow) {
+                spawnBalls(1);
+                lastSpawnTime = simTime;
+            }
+
+            balls.integrate(SIM_DT * timeScale(), width, height, jobs);
+        }
+
+        {
+            ProfileScope scope(profiler, PROFILE_COLLISION);
+            if (ballCollisions) {
+                collider.resolve(balls, jobs, BALL_IDLE_SPEED);
+            }
+            grid.rebuild(balls, jobs);
+
+            // Swept, so no step is coarse enough for a ball to pass through the hero
+            if (hero.checkCollision(balls, grid, BALL_IDLE_SPEED * SIM_DT * timeScale())) {
+                isGameOver = !invincible;
+            }
+        }
+    }
+
+    {
+        ProfileScope scope(profiler, PROFILE_PHASE);
+        updatePhase();
+    }
+
+    if (input.mousePressed) {
+        click(input.mouse);
+    }
+}
+
+float World::timeScale() const {
+    return hero.isMoving ? BALL_MOVING_SPEED / BALL_IDLE_SPEED : 1.0f;
+}
+
+void World::updatePhase() {
+    if (simTime - stateTime >= WHITE_PHASE_TIME && !isYellow) {
+        isYellow = true;
+        canDelete = true;
+        stateTime = simTime;
+    }
+
+    if (simTime - stateTime >= YELLOW_PHASE_TIME && isYellow) {
+        isYellow = false;
+        canDelete = false;
+        stateTime = simTime;
+        spawnBalls(1);
+    }
+}
+
+void World::click(Vec2 mousePoint) {
+    if (!canDelete) {
+        return;
+    }
+    ProfileScope scope(profiler, PROFILE_CLICK);
+    destroyInRadius(mousePoint, 0.0f);
+}
+
+// Destroys every destroyable ball touching the circle and scores it. A single grid
+// query finds the k hits and each removal is a swap-and-pop, so clearing a whole
+// area costs O(k) instead of an erase per ball. Hits are kept as handles because
+// each removal moves another ball to a new index.
+int World::destroyInRadius(Vec2 center, float areaRadius) {
+    if (!canDelete) {
+        return 0;
+    }
+    if (!grid.isBuilt()) {
+        grid.rebuild(balls, jobs);
+    }
+
+    hits.clear();
+    Rect area = {center.x - areaRadius, center.y - areaRadius, 2 * areaRadius, 2 * areaRadius};
+    grid.forEachNear(area, [&](int i) {
+        if (pointInCircle(center, {balls.posX(i), balls.posY(i)}, balls.radius[i] + areaRadius)) {
+            hits.push_back(balls.handleAt(i));
+        }
+        return false;
+    });
+    if (hits.empty()) {
+        return 0;
+    }
+
+    for (BallHandle hit : hits) {
+        int i = balls.indexOf(hit);
+        score += BALL_KINDS[balls.kind[i]].score;
+        balls.remove(i);
+    }
+    grid.invalidate();
+    return static_cast<int>(hits.size());
+}
+
+// FNV-1a over everything a replay has to reproduce exactly
+uint64_t World::stateHash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash = (hash ^ p[i]) * 1099511628211ULL;
+        }
+    };
+    int count = balls.size();
+    for (int i = 0; i < count; i++) {
+        float ball[5] = {balls.posX(i), balls.posY(i), balls.vx[i], balls.vy[i], balls.radius[i]};
+        mix(ball, sizeof(ball));
+        mix(&balls.kind[i], 1);
+    }
+    mix(&hero.heroRect, sizeof(hero.heroRect));
+    mix(&score, sizeof(score));
+    mix(&simTime, sizeof(simTime));
+    mix(&isGameOver, sizeof(isGameOver));
+    uint64_t rngState = rng.getState();
+    mix(&rngState, sizeof(rngState));
+    return hash;
+}
+
+void World::saveState(ByteWriter& out) const {
+    out.put<int32_t>(score);
+    out.put(simTime);
+    out.put(lastSpawnTime);
+    out.put(stateTime);
+    out.put<uint8_t>(isYellow);
+    out.put<uint8_t>(canDelete);
+    out.put<uint8_t>(isGameOver);
+    out.put<uint8_t>(invincible);
+    out.put<uint8_t>(ballCollisions);
+    out.put<int32_t>(startBalls);
+    out.put(rng.getState());
+    hero.save(out);
+    balls.save(out);
+    collider.save(out, balls);
+}
+
+bool World::loadState(ByteReader& in) {
+    score = in.get<int32_t>();
+    simTime = in.get<double>();
+    lastSpawnTime = in.get<double>();
+    stateTime = in.get<double>();
+    isYellow = in.get<uint8_t>() != 0;
+    canDelete = in.get<uint8_t>() != 0;
+    isGameOver = in.get<uint8_t>() != 0;
+    invincible = in.get<uint8_t>() != 0;
+    ballCollisions = in.get<uint8_t>() != 0;
+    startBalls = in.get<int32_t>();
+    rng.setState(in.get<uint64_t>());
+    grid.invalidate();
+    return in.ok() && hero.load(in) && balls.load(in) && collider.load(in, balls);
+}
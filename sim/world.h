@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ball_collisions.h"
+#include "ball_system.h"
+#include "byte_io.h"
+#include "config.h"
+#include "hero.h"
+#include "input.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "rng.h"
+#include "spatial_grid.h"
+#include <vector>
+
+// The whole game state and rules, stepped at SIM_HZ. Owns no window, textures
+// or audio, so it can be run headless as fast as the CPU allows.
+class World {
+public:
+    int width, height;
+    Hero hero;
+    BallSystem balls;      // Every kind of ball, told apart by BallSystem::kind
+    SpatialGrid grid;      // Ball buckets for hero and click queries
+    BallCollider collider;
+    int score;
+    double simTime;        // Simulated seconds since the world was created
+    double lastSpawnTime;
+    double stateTime;      // When the current white/yellow phase started
+    bool isYellow;         // Every ball is yellow and destroyable, read by drawing and clicks
+    bool canDelete;
+    bool isGameOver;
+    bool invincible;       // Keep running after a hit (profiling and soak runs)
+    bool ballCollisions;   // Game mode: balls bounce off each other
+    int startBalls;        // Extra balls spawned by reset(), for load testing
+    Rng rng;               // The only source of randomness in the simulation
+    JobSystem* jobs;       // Optional worker pool for the per-ball passes, not owned
+    FrameProfiler* profiler;  // Optional, not owned
+
+    // ballCapacity only sizes the pool up front; it still grows when full
+    World(int screenWidth, int screenHeight, uint64_t seed, int ballCapacity = BALL_POOL_CAPACITY);
+
+    void reset();
+    void step(const InputState& input);
+    void click(Vec2 mousePoint);
+    int destroyInRadius(Vec2 center, float areaRadius);  // Yellow phase only
+    // How fast ball time runs: time moves when you move. Ball velocities stay at the
+    // base speed and only the step they are integrated over changes.
+    float timeScale() const;
+    void spawnBalls(int count);
+    uint64_t stateHash() const;  // Fingerprint of the simulated state, for replay checks
+
+    // Full simulation state for replay keyframes. Loading restores the world exactly,
+    // so stepping on from a keyframe matches the original run bit for bit.
+    void saveState(ByteWriter& out) const;
+    bool loadState(ByteReader& in);
+
+private:
+    void spawnBall(BallKind ballKind);
+    void spawnRoundBalls();
+    void updatePhase();
+
+    std::vector<BallHandle> hits;  // Scratch for destroyInRadius()
+};
@@ -0,0 +1,277 @@
+// Microbenchmarks for the simulation's per-ball hot paths, at ball counts from
+// 10 up to a million, so the effect of an optimization can be measured and the
+// point where the working set falls out of each cache level shows up as a step
+// in ns/ball.
+//
+//   benchmarks [--max-balls N] [--csv FILE] [--simd scalar|sse2|avx2|avx512]
+//
+// Each case reports ns per item and items per second. Ball passes count balls;
+// queries and phase changes count once each. Cases marked "baseline" time the
+// original array-of-structs code the simulation replaced, for comparison.
+
+#include "../sim/ball_system.h"
+#include "../sim/config.h"
+#include "../sim/hero.h"
+#include "../sim/rng.h"
+#include "../sim/spatial_grid.h"
+#include "../sim/world.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+const double MIN_SECONDS = 0.05;  // Per case and size, split over as many runs as fit
+const double MIN_BLOCK_SECONDS = 0.001;  // Repeats are batched so the clock is read rarely
+
+// The ball record the game started with: everything about a ball in one struct,
+// its colour rewritten on every phase change and removed with vector::erase
+struct LegacyBall {
+    float x, y, xspeed, yspeed, radius;
+    unsigned char r, g, b, a;
+    bool destroyable;
+};
+
+static double Seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// For passes that leave the data usable: runs fn() back to back, doubling the
+// batch until a batch takes long enough to time, then times batches and returns
+// ns per item of the fastest, which is the least disturbed by the machine
+template <class Fn>
+static double MeasureRepeat(long items, Fn fn) {
+    long reps = 1;
+    for (;;) {
+        Clock::time_point start = Clock::now();
+        for (long r = 0; r < reps; r++) {
+            fn();
+        }
+        double block = Seconds(start);
+        if (block >= MIN_BLOCK_SECONDS) {
+            break;
+        }
+        reps *= 2;
+    }
+
+    double total = 0.0;
+    double best = 0.0;
+    while (total < MIN_SECONDS) {
+        Clock::time_point start = Clock::now();
+        for (long r = 0; r < reps; r++) {
+            fn();
+        }
+        double block = Seconds(start);
+        best = total == 0.0 || block < best ? block : best;
+        total += block;
+    }
+    return best * 1e9 / (static_cast<double>(reps) * items);
+}
+
+// For operations that consume their input: setup() rebuilds it untimed before
+// every run of fn(); the fastest run counts
+template <class Setup, class Fn>
+static double MeasureOnce(long items, Setup setup, Fn fn) {
+    double total = 0.0;
+    double best = 0.0;
+    int runs = 0;
+    while (total < MIN_SECONDS || runs < 3) {
+        setup();
+        Clock::time_point start = Clock::now();
+        fn();
+        double run = Seconds(start);
+        best = runs == 0 || run < best ? run : best;
+        total += run;
+        runs++;
+    }
+    return best * 1e9 / items;
+}
+
+struct Report {
+    FILE* csv;
+
+    void row(const char* name, int balls, double nsPerItem) {
+        printf("%-24s %9d %12.2f %14.0f\n", name, balls, nsPerItem, 1e9 / nsPerItem);
+        if (csv) {
+            fprintf(csv, "%s,%d,%.4f,%.0f\n", name, balls, nsPerItem, 1e9 / nsPerItem);
+        }
+    }
+};
+
+static void FillBalls(BallSystem& balls, int count, Rng& rng) {
+    balls.clear();
+    balls.reserve(count);
+    for (int i = 0; i < count; i++) {
+        float px = BALL_RADIUS + rng.range(SCREEN_WIDTH - 2 * BALL_RADIUS);
+        float py = BALL_RADIUS + rng.range(SCREEN_HEIGHT - 2 * BALL_RADIUS);
+        float vx = rng.range(2) ? BALL_IDLE_SPEED : -BALL_IDLE_SPEED;
+        float vy = rng.range(2) ? BALL_IDLE_SPEED : -BALL_IDLE_SPEED;
+        balls.spawn(px, py, vx, vy, BALL_RADIUS, BALL_REGULAR);
+    }
+}
+
+static void FillLegacy(std::vector<LegacyBall>& balls, const BallSystem& source) {
+    balls.resize(source.size());
+    for (int i = 0; i < source.size(); i++) {
+        balls[i] = {source.posX(i), source.posY(i), source.vx[i], source.vy[i], source.radius[i], 255, 255, 255, 255, false};
+    }
+}
+
+// Removals per run: enough to time, but bounded so erase stays affordable at 1M
+static int RemovalCount(int balls) {
+    int byWork = 100000000 / balls;
+    int count = balls / 2 < byWork ? balls / 2 : byWork;
+    return count > 0 ? count : 1;
+}
+
+static void BenchSize(int count, SimdLevel simd, Report& report) {
+    Rng rng(static_cast<uint64_t>(count));
+    BallSystem balls;
+    balls.setSimdLevel(simd);
+    FillBalls(balls, count, rng);
+    BallSystem pristine = balls;
+
+    // Integration: one fixed step of movement and wall reflection
+    report.row("integrate", count, MeasureRepeat(count, [&] {
+        balls.integrate(SIM_DT, SCREEN_WIDTH, SCREEN_HEIGHT);
+    }));
+    balls.setSimdLevel(SIMD_SCALAR);
+    report.row("integrate scalar", count, MeasureRepeat(count, [&] {
+        balls.integrate(SIM_DT, SCREEN_WIDTH, SCREEN_HEIGHT);
+    }));
+    balls.setSimdLevel(simd);
+
+    // Hero collision: the grid rebuild every step pays, then one swept query. Balls
+    // touching the hero are cleared first, so the query never stops at a hit and
+    // tests every candidate, as in a step the hero survives.
+    SpatialGrid grid(SCREEN_WIDTH, SCREEN_HEIGHT);
+    report.row("grid rebuild", count, MeasureRepeat(count, [&] {
+        grid.rebuild(balls);
+    }));
+    Hero hero(5, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, HERO_FRAME_WIDTH, HERO_FRAME_HEIGHT);
+    Rect clearance = hero.heroRect;
+    clearance.x -= 2 * BALL_RADIUS;
+    clearance.y -= 2 * BALL_RADIUS;
+    clearance.width += 4 * BALL_RADIUS;
+    clearance.height += 4 * BALL_RADIUS;
+    for (int i = balls.size() - 1; i >= 0; i--) {
+        if (circleRectOverlap({balls.posX(i), balls.posY(i)}, balls.radius[i], clearance)) {
+            balls.remove(i);
+        }
+    }
+    grid.rebuild(balls);
+    volatile bool sink = false;
+    report.row("hero collision (query)", count, MeasureRepeat(1, [&] {
+        sink = hero.checkCollision(balls, grid, BALL_IDLE_SPEED * SIM_DT);
+    }));
+
+    // Click destruction: removing scattered balls one at a time
+    int removals = RemovalCount(count);
+    std::vector<int> targets(removals);
+    for (int k = 0; k < removals; k++) {
+        targets[k] = rng.range(count - k);
+    }
+    report.row("remove swap-pop", count, MeasureOnce(removals, [&] { balls = pristine; }, [&] {
+        for (int i : targets) {
+            balls.remove(i);
+        }
+    }));
+    std::vector<LegacyBall> legacy;
+    report.row("remove erase (baseline)", count, MeasureOnce(removals, [&] { FillLegacy(legacy, pristine); }, [&] {
+        for (int i : targets) {
+            legacy.erase(legacy.begin() + i);
+        }
+    }));
+
+    // Spawning into a reserved pool, and into an empty one that grows as it goes
+    report.row("spawn (pooled)", count, MeasureOnce(count, [&] { balls.clear(); balls.reserve(count); }, [&] {
+        for (int i = 0; i < count; i++) {
+            balls.spawn(pristine.x[i], pristine.y[i], pristine.vx[i], pristine.vy[i], BALL_RADIUS, BALL_REGULAR);
+        }
+    }));
+    report.row("spawn (growing)", count, MeasureOnce(count, [&] { balls = BallSystem(); balls.setSimdLevel(simd); }, [&] {
+        for (int i = 0; i < count; i++) {
+            balls.spawn(pristine.x[i], pristine.y[i], pristine.vx[i], pristine.vy[i], BALL_RADIUS, BALL_REGULAR);
+        }
+    }));
+
+    // Phase change: the original rewrote every ball's colour and flag; the world
+    // now flips one flag, timed once in BenchPhaseFlip
+    FillLegacy(legacy, pristine);
+    bool yellow = false;
+    report.row("recolor (baseline)", count, MeasureRepeat(1, [&] {
+        yellow = !yellow;
+        for (LegacyBall& ball : legacy) {
+            ball.b = yellow ? 0 : 255;
+            ball.destroyable = yellow;
+        }
+    }));
+    (void)sink;
+}
+
+// The world flips one flag that drawing reads once per frame, so the cost of a
+// phase change does not depend on the ball count; reported once, at 0 balls
+static void BenchPhaseFlip(Report& report) {
+    World world(SCREEN_WIDTH, SCREEN_HEIGHT, 1);
+    volatile bool sink = false;
+    report.row("phase flip (per change)", 0, MeasureRepeat(1, [&] {
+        world.isYellow = !world.isYellow;
+        world.canDelete = world.isYellow;
+        sink = world.isYellow;
+    }));
+    (void)sink;
+}
+
+static void Usage() {
+    std::cerr << "usage: benchmarks [--max-balls N] [--csv FILE] [--simd scalar|sse2|avx2|avx512]\n";
+}
+
+int main(int argc, char** argv) {
+    int maxBalls = 1000000;
+    const char* csvFile = nullptr;
+    SimdLevel simd = DetectSimdLevel();
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--max-balls") == 0 && hasValue) {
+            maxBalls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvFile = argv[++i];
+        } else if (strcmp(argv[i], "--simd") == 0 && hasValue) {
+            if (!ParseSimdLevel(argv[++i], simd)) {
+                Usage();
+                return 1;
+            }
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+
+    Report report = {nullptr};
+    if (csvFile) {
+        report.csv = fopen(csvFile, "w");
+        if (!report.csv) {
+            std::cerr << "benchmarks: cannot write " << csvFile << "\n";
+            return 1;
+        }
+        fprintf(report.csv, "case,balls,ns_per_item,items_per_sec\n");
+    }
+
+    printf("kernel: %s\n\n", SimdLevelName(ClampSimdLevel(simd)));
+    printf("%-24s %9s %12s %14s\n", "case", "balls", "ns/item", "items/sec");
+    BenchPhaseFlip(report);
+    printf("\n");
+    for (int count = 10; count <= maxBalls; count *= 10) {
+        BenchSize(count, simd, report);
+        printf("\n");
+    }
+
+    if (report.csv && fclose(report.csv) != 0) {
+        std::cerr << "benchmarks: cannot write " << csvFile << "\n";
+        return 1;
+    }
+    return 0;
+}
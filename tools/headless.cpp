@@ -0,0 +1,342 @@
+// Headless driver: steps the simulation without a window, GPU or audio device
+// and reports throughput, so the hot path can be profiled on build machines.
+//
+//   headless [--steps N] [--balls N] [--seed N] [--script FILE] [--invincible] [--quantized]
+//            [--simd scalar|sse2|avx2|avx512] [--ball-collisions] [--threads N]
+//            [--profile CSV] [--record FILE | --replay FILE [--seek MS]] [--envs N]
+//
+// --record writes the seed, options, keyframes and every step's input to FILE;
+// --replay runs such a file instead of the script and must end on the same state
+// hash. --seek starts the replay from a keyframe near MS rather than from step 0.
+//
+// --envs runs N independent games through the batched environment API instead,
+// each under a random policy, for --steps batch steps, and reports environment
+// steps per second.
+//
+// A script is a list of "<steps> <keys> [click <x> <y>]" lines, where keys is any
+// of W, A, S, D or "-" for none. The script loops until all steps have run.
+
+#include "../sim/config.h"
+#include "../sim/replay.h"
+#include "../sim/rng.h"
+#include "../sim/vec_env.h"
+#include "../sim/world.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ScriptLine {
+    int steps;
+    InputState input;
+};
+
+static bool ParseScript(const char* fileName, std::vector<ScriptLine>& script) {
+    std::ifstream file(fileName);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream in(line);
+        ScriptLine entry;
+        std::string keys, word;
+        if (!(in >> entry.steps >> keys) || entry.steps <= 0) {
+            return false;
+        }
+        for (char c : keys) {
+            switch (c) {
+                case 'W': case 'w': entry.input.up = true; break;
+                case 'S': case 's': entry.input.down = true; break;
+                case 'A': case 'a': entry.input.left = true; break;
+                case 'D': case 'd': entry.input.right = true; break;
+                case '-': break;
+                default: return false;
+            }
+        }
+        if (in >> word) {
+            if (word != "click" || !(in >> entry.input.mouse.x >> entry.input.mouse.y)) {
+                return false;
+            }
+            entry.input.mousePressed = true;
+        }
+        script.push_back(entry);
+    }
+    return !script.empty();
+}
+
+// Walks the hero in a square so ball speed alternates between moving and idle
+static std::vector<ScriptLine> DefaultScript() {
+    std::vector<ScriptLine> script(5);
+    script[0].steps = 30; script[0].input.right = true;
+    script[1].steps = 30; script[1].input.down = true;
+    script[2].steps = 30; script[2].input.left = true;
+    script[3].steps = 30; script[3].input.up = true;
+    script[4].steps = 60;
+    return script;
+}
+
+static void Usage() {
+    std::cerr << "usage: headless [--steps N] [--balls N] [--seed N] [--script FILE] [--invincible] [--quantized]\n"
+                 "                [--simd scalar|sse2|avx2|avx512] [--ball-collisions] [--threads N]\n"
+                 "                [--profile CSV] [--record FILE | --replay FILE [--seek MS]] [--envs N]\n";
+}
+
+// Each environment holds a random set of keys for a random number of steps and
+// clicks now and then, which is enough to exercise every rule
+static int RunEnvs(int count, long steps, uint64_t seed, int extraBalls, bool ballCollisions, int threads) {
+    JobSystem jobs(threads);
+    VecEnvConfig config;
+    config.count = count;
+    config.seed = seed;
+    config.startBalls = extraBalls;
+    config.ballCollisions = ballCollisions;
+    VecEnv env(config, &jobs);
+
+    Rng policy(seed);
+    std::vector<uint8_t> actions(count, 0);
+    std::vector<int> holdSteps(count, 0);
+    std::vector<Vec2> clicks(count, {0.0f, 0.0f});
+    std::vector<double> returns(count, 0.0);
+    double finishedReturn = 0.0;
+
+    double seconds = 0.0;
+    for (long s = 0; s < steps; s++) {
+        for (int i = 0; i < count; i++) {
+            actions[i] &= ~ACTION_CLICK;
+            if (--holdSteps[i] <= 0) {
+                actions[i] = static_cast<uint8_t>(policy.range(16));
+                holdSteps[i] = 10 + policy.range(50);
+            }
+            if (policy.range(30) == 0) {
+                actions[i] |= ACTION_CLICK;
+                clicks[i] = {static_cast<float>(policy.range(SCREEN_WIDTH)), static_cast<float>(policy.range(SCREEN_HEIGHT))};
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        env.step(actions.data(), clicks.data());
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const float* rewards = env.rewards();
+        const uint8_t* dones = env.dones();
+        for (int i = 0; i < count; i++) {
+            returns[i] += rewards[i];
+            if (dones[i]) {
+                finishedReturn += returns[i];
+                returns[i] = 0.0;
+            }
+        }
+    }
+
+    // Order-independent, so it must match for any thread count
+    uint64_t hash = 0;
+    for (int i = 0; i < count; i++) {
+        hash ^= env.world(i).stateHash() * (2 * static_cast<uint64_t>(i) + 1);
+    }
+
+    printf("envs:         %d\n", count);
+    printf("threads:      %d\n", jobs.threadCount());
+    printf("env steps:    %lld\n", env.totalSteps());
+    printf("step time:    %.3f s\n", seconds);
+    printf("steps/sec:    %.0f\n", seconds > 0 ? env.totalSteps() / seconds : 0.0);
+    printf("episodes:     %lld\n", env.episodes());
+    printf("mean return:  %.1f\n", env.episodes() > 0 ? finishedReturn / env.episodes() : 0.0);
+    printf("state hash:   %016llx\n", (unsigned long long)hash);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long steps = 100000;
+    int extraBalls = 0;
+    uint64_t seed = 1;
+    bool invincible = false;
+    bool quantized = false;
+    bool ballCollisions = false;
+    int threads = 0;
+    const char* profileFile = nullptr;
+    SimdLevel simd = DetectSimdLevel();
+    const char* scriptFile = nullptr;
+    const char* recordFile = nullptr;
+    const char* replayFile = nullptr;
+    double seekMs = -1.0;
+    int envs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--steps") == 0 && hasValue) {
+            steps = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--balls") == 0 && hasValue) {
+            extraBalls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+            scriptFile = argv[++i];
+        } else if (strcmp(argv[i], "--invincible") == 0) {
+            invincible = true;
+        } else if (strcmp(argv[i], "--quantized") == 0) {
+            quantized = true;
+        } else if (strcmp(argv[i], "--ball-collisions") == 0) {
+            ballCollisions = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0 && hasValue) {
+            profileFile = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordFile = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayFile = argv[++i];
+        } else if (strcmp(argv[i], "--envs") == 0 && hasValue) {
+            envs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seek") == 0 && hasValue) {
+            seekMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--simd") == 0 && hasValue) {
+            if (!ParseSimdLevel(argv[++i], simd)) {
+                Usage();
+                return 1;
+            }
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+
+    if ((recordFile && replayFile) || (seekMs >= 0.0 && !replayFile) ||
+        (envs != 0 && (envs < 0 || recordFile || replayFile || scriptFile))) {
+        Usage();
+        return 1;
+    }
+    if (envs > 0) {
+        return RunEnvs(envs, steps, seed, extraBalls, ballCollisions, threads);
+    }
+
+    std::vector<ScriptLine> script;
+    if (scriptFile) {
+        if (!ParseScript(scriptFile, script)) {
+            std::cerr << "headless: cannot read script " << scriptFile << "\n";
+            return 1;
+        }
+    } else {
+        script = DefaultScript();
+    }
+
+    // A replay brings its own seed, world size and options
+    ReplayPlayer player;
+    ReplayHeader header;
+    if (replayFile) {
+        if (!player.open(replayFile)) {
+            std::cerr << "headless: cannot read replay " << replayFile << "\n";
+            return 1;
+        }
+        header = player.getHeader();
+        steps = player.stepCount();
+    } else {
+        header.simHz = SIM_HZ;
+        header.width = SCREEN_WIDTH;
+        header.height = SCREEN_HEIGHT;
+        header.seed = seed;
+        header.startBalls = extraBalls;
+        header.options = (invincible ? REPLAY_INVINCIBLE : 0) |
+                         (ballCollisions ? REPLAY_BALL_COLLISIONS : 0) |
+                         (quantized ? REPLAY_QUANTIZED : 0);
+    }
+
+    JobSystem jobs(threads);
+    World world(header.width, header.height, header.seed);
+    world.jobs = &jobs;
+    FrameProfiler profiler;
+    if (profileFile) {
+        world.profiler = &profiler;  // Each step counts as one frame
+    }
+    world.balls.setSimdLevel(simd);
+    header.apply(world);
+    if (seekMs >= 0.0) {
+        auto seekStart = std::chrono::steady_clock::now();
+        if (!player.seek(world, seekMs)) {
+            std::cerr << "headless: cannot seek " << replayFile << "\n";
+            return 1;
+        }
+        double seekSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - seekStart).count();
+        printf("seek:         %.0f ms in %.3f ms\n", player.positionMs(), seekSeconds * 1000.0);
+        steps = player.stepCount() - player.position();
+    }
+
+    ReplayRecorder recorder;
+    if (recordFile && !recorder.open(recordFile, header)) {
+        std::cerr << "headless: cannot write " << recordFile << "\n";
+        return 1;
+    }
+
+    int games = 1;
+    size_t line = 0;
+    int lineStep = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < steps; i++) {
+        InputState input;
+        if (replayFile) {
+            player.next(input);
+        } else {
+            const ScriptLine& entry = script[line];
+            input = entry.input;
+            input.mousePressed = input.mousePressed && lineStep == 0;  // Clicks fire once per line
+            input.restart = world.isGameOver;  // Retry straight away, like a player hammering the button
+            if (++lineStep >= entry.steps) {
+                lineStep = 0;
+                line = (line + 1) % script.size();
+            }
+        }
+        if (input.restart && world.isGameOver) {
+            games++;
+        }
+        recorder.record(world, input);
+
+        if (profileFile) {
+            profiler.beginFrame();
+        }
+        world.step(input);
+        if (profileFile) {
+            profiler.endFrame();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("steps:        %ld\n", steps);
+    printf("simulated:    %.1f s\n", steps * (double)SIM_DT);
+    printf("wall time:    %.3f s\n", seconds);
+    printf("steps/sec:    %.0f\n", seconds > 0 ? steps / seconds : 0.0);
+    printf("games:        %d\n", games);
+    printf("balls:        %d\n", world.balls.size());
+    printf("threads:      %d\n", jobs.threadCount());
+    printf("kernel:       %s\n", world.balls.isQuantized() ? "quantized" : SimdLevelName(world.balls.getSimdLevel()));
+    printf("score:        %d\n", world.score);
+    printf("state hash:   %016llx\n", (unsigned long long)world.stateHash());
+
+    if (!recorder.close()) {
+        std::cerr << "headless: cannot write " << recordFile << "\n";
+        return 1;
+    }
+
+    if (profileFile) {
+        printf("\n%-10s %10s %10s %10s   (last %d steps)\n", "phase", "min ms", "avg ms", "p99 ms", FrameProfiler::WINDOW);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+            ProfilePhase phase = static_cast<ProfilePhase>(p);
+            ProfileStats stats = profiler.stats(phase);
+            printf("%-10s %10.4f %10.4f %10.4f\n", FrameProfiler::phaseName(phase), stats.minMs, stats.avgMs, stats.p99Ms);
+        }
+        if (!profiler.writeCsv(profileFile)) {
+            std::cerr << "headless: cannot write " << profileFile << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
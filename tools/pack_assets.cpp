@@ -0,0 +1,196 @@
+// Offline asset packer: decodes images and audio once at build time and writes
+// them into one archive the game memory-maps at startup (see client/asset_pack.h).
+//
+//   pack_assets OUT.pak FILE... [--atlas NAME IMAGE...]
+//
+// Images become RGBA8 pixels, audio
+// becomes 16-bit PCM at its original rate and channel count. The images after
+// --atlas are packed into one texture called NAME, stored with its region table.
+
+#include "raylib.h"
+#include "../client/asset_pack.h"
+#include "../client/raylib_compat.h"
+#include "../client/atlas.h"
+#include "../sim/byte_io.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+struct PackedAsset {
+    PackEntry entry;
+    std::vector<unsigned char> blob;
+};
+
+static bool IsAudio(const char* fileName) {
+    return IsFileExtension(fileName, ".mp3;.wav;.ogg;.flac");
+}
+
+static bool PackImage(const char* fileName, PackedAsset& asset) {
+    Image image = LoadImage(fileName);
+    if (!image.data) {
+        return false;
+    }
+    ImageFormat(&image, PIXEL_FORMAT_RGBA8);
+    // Base level only; the loader has the GPU build any mipmaps
+    const unsigned char* pixels = static_cast<const unsigned char*>(image.data);
+    asset.blob.assign(pixels, pixels + GetPixelDataSize(image.width, image.height, image.format));
+    asset.entry.kind = PACK_TEXTURE;
+    asset.entry.params[0] = image.width;
+    asset.entry.params[1] = image.height;
+    asset.entry.params[2] = 1;
+    asset.entry.params[3] = image.format;
+    UnloadImage(image);
+    return true;
+}
+
+static bool PackAudio(const char* fileName, PackedAsset& asset) {
+    Wave wave = LoadWave(fileName);
+    if (!wave.data) {
+        return false;
+    }
+    WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    unsigned int sampleCount = WaveSampleTotal(wave);
+    const unsigned char* samples = static_cast<const unsigned char*>(wave.data);
+    asset.blob.assign(samples, samples + static_cast<size_t>(sampleCount) * wave.sampleSize / 8);
+    asset.entry.kind = PACK_SOUND;
+    asset.entry.params[0] = static_cast<int32_t>(sampleCount);
+    asset.entry.params[1] = static_cast<int32_t>(wave.sampleRate);
+    asset.entry.params[2] = static_cast<int32_t>(wave.sampleSize);
+    asset.entry.params[3] = static_cast<int32_t>(wave.channels);
+    UnloadWave(wave);
+    return true;
+}
+
+static bool PackAtlas(const char* name, const std::vector<const char*>& fileNames,
+                      PackedAsset& texture, PackedAsset& table) {
+    std::vector<Image> images;
+    std::vector<std::string> names;
+    bool ok = true;
+    for (const char* fileName : fileNames) {
+        Image image = LoadImage(fileName);
+        if (!image.data) {
+            std::cerr << "pack_assets: cannot load " << fileName << "\n";
+            ok = false;
+            continue;
+        }
+        ImageFormat(&image, PIXEL_FORMAT_RGBA8);
+        images.push_back(image);
+        names.push_back(fileName);
+    }
+    if (ok) {
+        std::vector<AtlasRegion> regions;
+        Image atlas = BuildAtlasImage(images, names, regions);
+        const unsigned char* pixels = static_cast<const unsigned char*>(atlas.data);
+        texture.blob.assign(pixels, pixels + GetPixelDataSize(atlas.width, atlas.height, atlas.format));
+        texture.entry.name = name;
+        texture.entry.kind = PACK_TEXTURE;
+        texture.entry.params[0] = atlas.width;
+        texture.entry.params[1] = atlas.height;
+        texture.entry.params[2] = 1;
+        texture.entry.params[3] = atlas.format;
+        UnloadImage(atlas);
+
+        ByteWriter out(table.blob);
+        WriteAtlasRegions(out, regions);
+        table.entry.name = name;
+        table.entry.kind = PACK_ATLAS;
+    }
+    for (Image& image : images) {
+        UnloadImage(image);
+    }
+    return ok;
+}
+
+static uint64_t AlignUp(uint64_t offset) {
+    return (offset + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: pack_assets OUT.pak FILE... [--atlas NAME IMAGE...]\n";
+        return 1;
+    }
+    const char* outFile = argv[1];
+    int last = argc;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--atlas") == 0) {
+            last = i;
+            break;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    std::vector<PackedAsset> assets;
+    if (last < argc) {
+        if (argc - last < 3) {
+            std::cerr << "pack_assets: --atlas needs a name and at least one image\n";
+            return 1;
+        }
+        PackedAsset texture = PackedAsset();
+        PackedAsset table = PackedAsset();
+        if (!PackAtlas(argv[last + 1], std::vector<const char*>(argv + last + 2, argv + argc), texture, table)) {
+            return 1;
+        }
+        assets.push_back(texture);
+        assets.push_back(table);
+    }
+    for (int i = 2; i < last; i++) {
+        PackedAsset asset = PackedAsset();
+        asset.entry.name = argv[i];
+        bool ok = IsAudio(argv[i]) ? PackAudio(argv[i], asset) : PackImage(argv[i], asset);
+        if (!ok || asset.entry.name.size() > 255) {
+            std::cerr << "pack_assets: cannot pack " << argv[i] << "\n";
+            return 1;
+        }
+        assets.push_back(asset);
+    }
+
+    // The table's size does not depend on the offsets, so lay it out once to measure it
+    std::vector<unsigned char> table;
+    ByteWriter out(table);
+    auto writeTable = [&]() {
+        table.clear();
+        out.putBytes(PACK_MAGIC, sizeof(PACK_MAGIC));
+        out.put(static_cast<uint32_t>(assets.size()));
+        for (const PackedAsset& asset : assets) {
+            out.put(static_cast<uint8_t>(asset.entry.kind));
+            out.put(static_cast<uint8_t>(asset.entry.name.size()));
+            out.putBytes(asset.entry.name.data(), asset.entry.name.size());
+            out.put(asset.entry.offset);
+            out.put(asset.entry.size);
+            for (int32_t param : asset.entry.params) {
+                out.put(param);
+            }
+        }
+    };
+    writeTable();
+    uint64_t offset = AlignUp(table.size());
+    for (PackedAsset& asset : assets) {
+        asset.entry.offset = offset;
+        asset.entry.size = asset.blob.size();
+        offset = AlignUp(offset + asset.blob.size());
+    }
+    writeTable();
+
+    FILE* file = fopen(outFile, "wb");
+    if (!file) {
+        std::cerr << "pack_assets: cannot write " << outFile << "\n";
+        return 1;
+    }
+    bool ok = fwrite(table.data(), 1, table.size(), file) == table.size();
+    std::vector<unsigned char> padding(PACK_ALIGN, 0);
+    uint64_t written = table.size();
+    for (const PackedAsset& asset : assets) {
+        ok = ok && fwrite(padding.data(), 1, asset.entry.offset - written, file) == asset.entry.offset - written;
+        ok = ok && fwrite(asset.blob.data(), 1, asset.blob.size(), file) == asset.blob.size();
+        written = asset.entry.offset + asset.blob.size();
+        printf("%-24s %10llu bytes\n", asset.entry.name.c_str(), (unsigned long long)asset.blob.size());
+    }
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "pack_assets: cannot write " << outFile << "\n";
+        return 1;
+    }
+    return 0;
+}